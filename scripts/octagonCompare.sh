@@ -0,0 +1,32 @@
+#!/usr/bin/env bash
+
+# Compare the native octagon analysis with the Apron octagon analysis on regression tests.
+# ./scripts/octagonCompare.sh [tests/regression/24-octagon/*.c tests/regression/36-apron/*.c]
+
+OUTDIR="octagonCompareRes"
+
+mkdir -p $OUTDIR
+
+if [ $# -eq 0 ]; then
+    set -- tests/regression/24-octagon/*.c tests/regression/36-apron/*.c
+fi
+
+printf "%-60s %12s %12s %10s %10s\n" "test" "apron succ" "native succ" "apron s" "native s"
+for FILE in "$@"; do
+    PARAM=$(head -n 1 "$FILE" | sed -n 's/^\/\/.*PARAM: *//p')
+    NAME=$(basename "$(dirname "$FILE")")-$(basename "$FILE" .c)
+    # apron is the default octagon domain of ana.apron.domain
+    APRON_PARAM="$PARAM"
+    NATIVE_PARAM=${PARAM//ana.activated\[+\] apron/ana.activated[+] octagon}
+    if [ "$APRON_PARAM" = "$NATIVE_PARAM" ]; then
+        continue # doesn't use apron
+    fi
+    START=$(date +%s.%N)
+    eval ./goblint "$APRON_PARAM" "$FILE" > "$OUTDIR/$NAME.apron.txt" 2>&1
+    MID=$(date +%s.%N)
+    eval ./goblint "$NATIVE_PARAM" "$FILE" > "$OUTDIR/$NAME.native.txt" 2>&1
+    END=$(date +%s.%N)
+    APRON_SUCC=$(grep -c "will succeed" "$OUTDIR/$NAME.apron.txt")
+    NATIVE_SUCC=$(grep -c "will succeed" "$OUTDIR/$NAME.native.txt")
+    printf "%-60s %12d %12d %10.2f %10.2f\n" "$FILE" "$APRON_SUCC" "$NATIVE_SUCC" "$(echo "$MID - $START" | bc)" "$(echo "$END - $MID" | bc)"
+done
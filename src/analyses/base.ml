@@ -3134,6 +3134,12 @@ struct
           {st' with cpa = CPA.remove !longjmp_return st'.cpa}
         | None -> man.local
       end
+    | Events.GlobalInit {var; init} ->
+      let value = match init with
+        | None -> VD.zero_init_value ~varAttr:var.vattr var.vtype
+        | Some init -> VD.of_init ~varAttr:var.vattr (eval_rv ~man st) var.vtype init
+      in
+      set ~man st (AD.of_var var) var.vtype value
     | _ ->
       man.local
 end
@@ -85,7 +85,7 @@ module NoWrapper:PrivatizationWrapper = functor (GBase:Lattice.S) ->
 
 module DigestWrapper(Digest: Digest):PrivatizationWrapper =  functor (GBase:Lattice.S) ->
   (struct
-    module G = MapDomain.MapBot_LiftTop (Digest) (GBase)
+    module G = CompactMap (struct let name = "privatization map G" end) (Digest) (GBase)
 
     let getg ask getg x =
       let vs = getg x in
@@ -2121,7 +2121,7 @@ let priv_module: (module S) Lazy.t =
       )
     in
     let module Priv = PrecisionDumpPriv (Priv) in
-    (* let module Priv = TimedPriv (Priv) in *)
+    let module Priv = (val if get_bool "dbg.timing.enabled" then (module TimedPriv (Priv): S) else (module Priv)) in
     let module Priv = TracingPriv (Priv) in
     (module Priv)
   )
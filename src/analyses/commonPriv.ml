@@ -237,6 +237,26 @@ struct
     | _ -> false
 end
 
+(** Map for thread digest- and lock-indexed components of privatizations.
+    Bindings are kept in sorted arrays and hashconsed if [ana.opt.hashcons-priv] is enabled,
+    such that joins of unchanged maps, e.g. repeated side effects at unlock, are decided by their tags.
+    Like for address sets, the option is read once per process, because tagged and untagged maps mustn't be mixed, e.g. between server requests.
+    [Name.name] names the memo tables of the instance in the statistics. *)
+(* HAS SIDE-EFFECTS ---- PLEASE INSTANCIATE ONLY ONCE!!! *)
+module CompactMap (Name: sig val name: string end) (Domain: Printable.S) (Range: Lattice.S) =
+struct
+  module HConsedArg =
+  struct
+    let name = Name.name
+    let enabled = Lazy.from_fun (fun () -> GobConfig.get_bool "ana.opt.hashcons-priv")
+    let enabled () = Lazy.force enabled
+    let memo_size = 4096
+  end
+  module M = MapDomain.HConsedOpt (MapDomain.ArrayMapBot (Domain) (Range)) (HConsedArg)
+  include MapDomain.LiftTop (Range) (M)
+  let name () = "map"
+end
+
 module PerMutexTidCommon (Digest: Digest) (LD:Lattice.S) =
 struct
   include ConfCheck.RequireThreadFlagPathSensInit
@@ -275,10 +295,10 @@ struct
   (* Map from locks to last written values thread-locally *)
   module L =
   struct
-    include MapDomain.MapBot_LiftTop (LLock) (LD)
+    include CompactMap (struct let name = "privatization map L" end) (LLock) (LD)
     let name () = "L"
   end
-  module GMutex = MapDomain.MapBot_LiftTop (Digest) (LD)
+  module GMutex = CompactMap (struct let name = "privatization map GMutex" end) (Digest) (LD)
   module GThread = Lattice.Prod (LMust) (L)
 
   module G =
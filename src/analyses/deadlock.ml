@@ -47,69 +47,211 @@ struct
 
   module G = Arg.G (* help type checker using explicit constraint *)
 
-  let query man (type a) (q: a Queries.t): a Queries.result =
-    match q with
-    | WarnGlobal g ->
-      let g: V.t = Obj.obj g in
+  module LH = Hashtbl.Make (Lock)
+  module IM = Map.Make (Int)
 
-      let module LH = Hashtbl.Make (Lock) in
-      let module LS = Set.Make (Lock) in
-      (* TODO: find all cycles/SCCs *)
-      let global_visited_locks = LH.create 100 in
+  (** Lock-order graph, read from globals once per lock during postsolving. *)
+  let graph: G.t LH.t = LH.create 100
 
-      let may_equal l1 l2 = match l1, l2 with
-        | ValueDomain.Addr.UnknownPtr, _
-        | _, ValueDomain.Addr.UnknownPtr ->
-          true
-        | _, _ -> Lock.equal l1 l2
-      in
+  (** Locks whose SCCs have been checked for cycles. *)
+  let checked: unit LH.t = LH.create 100
+
+  let init marshal =
+    LH.clear graph;
+    LH.clear checked;
+    init marshal
+
+  (** Report locking order cycles among the locks reachable from [g] in the lock-order graph.
+
+      Strongly connected components are found by Tarjan's algorithm.
+      Elementary cycles of locks in non-trivial ones are enumerated by Johnson's algorithm, up to [ana.deadlock.max-cycles].
+      Lock event pairs along such a cycle are chosen one edge at a time, such that each new pair may happen in parallel with the previous ones.
+      [UnknownPtr] may equal any lock, so edges to it are edges to all locks and edges from it are edges from all locks. *)
+  let warn_cycles man g =
+    let global l =
+      match LH.find_option graph l with
+      | Some d -> d
+      | None ->
+        let d = man.global l in
+        LH.replace graph l d;
+        d
+    in
+
+    (* explore reachable locks *)
+    let index = LH.create 100 in
+    let locks = ref [] in
+    let rec explore l =
+      if not (LH.mem index l) then (
+        LH.replace index l (LH.length index);
+        locks := l :: !locks;
+        G.iter (fun to_lock _ -> explore to_lock) (global l)
+      )
+    in
+    explore g;
+    let locks = Array.of_list (List.rev !locks) in
+    let n = Array.length locks in
+    let unknown = LH.find_option index ValueDomain.Addr.UnknownPtr in
+
+    (* edges with lock event pairs *)
+    let edges = Array.make n IM.empty in
+    let add_edge i j pairs =
+      edges.(i) <- IM.modify_def (MayLockEventPairs.empty ()) j (MayLockEventPairs.union pairs) edges.(i)
+    in
+    let add_edges i d =
+      G.iter (fun to_lock pairs ->
+          let j = LH.find index to_lock in
+          if Some j = unknown then
+            for j' = 0 to n - 1 do add_edge i j' pairs done
+          else
+            add_edge i j pairs
+        ) d
+    in
+    Array.iteri (fun i l ->
+        add_edges i (global l);
+        match unknown with
+        | Some u when u <> i -> add_edges i (global locks.(u))
+        | _ -> ()
+      ) locks;
 
-      (* DFS *)
-      let rec iter_lock (path_visited_locks: LS.t) (path_visited_lock_event_pairs: LockEventPair.t list) (lock: Lock.t) =
-        if LS.mem lock path_visited_locks || LS.mem ValueDomain.Addr.UnknownPtr path_visited_locks || (not (LS.is_empty path_visited_locks) && lock = ValueDomain.Addr.UnknownPtr) then (
-          (* cycle may not return to first lock, but an intermediate one, cut off the non-cyclic stem *)
-          let path_visited_lock_event_pairs =
-            (* path_visited_lock_event_pairs cannot be empty *)
-            List.hd path_visited_lock_event_pairs ::
-            List.take_while (fun (_, (after_lock, _, _)) ->
-                not (may_equal after_lock lock)
-              ) (List.tl path_visited_lock_event_pairs)
-          in
-          let mhp =
-            Enum.cartesian_product (List.enum path_visited_lock_event_pairs) (List.enum path_visited_lock_event_pairs)
-            |> Enum.for_all (fun (((_, (_, _, access1)) as p1), ((_, (_, _, access2)) as p2)) ->
-                LockEventPair.equal p1 p2 || MCPAccess.A.may_race access1 access2
-              )
-          in
-          if mhp then (
-            (* normalize path_visited_lock_event_pairs such that we don't get the same cycle multiple times, starting from different events *)
-            let min = List.min ~cmp:LockEventPair.compare path_visited_lock_event_pairs in
-            let (mini, _) = List.findi (fun i x -> LockEventPair.equal min x) path_visited_lock_event_pairs in
-            let (init, tail) = List.split_at mini path_visited_lock_event_pairs in
-            let normalized = List.rev_append init (List.rev tail) in (* backwards to get correct printout order *)
-            let msgs = List.concat_map (fun ((before_lock, before_node, before_access), (after_lock, after_node, after_access)) ->
-                [
-                  (Pretty.dprintf "lock before: %a with %a" Lock.pretty before_lock MCPAccess.A.pretty before_access, Some (M.Location.Node before_node));
-                  (Pretty.dprintf "lock after: %a with %a" Lock.pretty after_lock MCPAccess.A.pretty after_access, Some (M.Location.Node after_node));
-                ]
-              ) normalized
-            in
-            M.msg_group Warning ~category:Deadlock "Locking order cycle" msgs
+    (* Tarjan's SCCs *)
+    let scc = Array.make n (-1) in
+    let lowlink = Array.make n 0 in
+    let number = Array.make n (-1) in
+    let on_stack = Array.make n false in
+    let stack = ref [] in
+    let counter = ref 0 in
+    let sccs = ref 0 in
+    let rec strongconnect i =
+      number.(i) <- !counter;
+      lowlink.(i) <- !counter;
+      incr counter;
+      stack := i :: !stack;
+      on_stack.(i) <- true;
+      IM.iter (fun j _ ->
+          if number.(j) < 0 then (
+            strongconnect j;
+            lowlink.(i) <- min lowlink.(i) lowlink.(j)
           )
-        )
-        else if not (LH.mem global_visited_locks lock) then begin
-          LH.replace global_visited_locks lock ();
-          let new_path_visited_locks = LS.add lock path_visited_locks in
-          G.iter (fun to_lock lock_event_pairs ->
-              MayLockEventPairs.iter (fun lock_event_pair ->
-                  let new_path_visited_lock_event_pairs' = lock_event_pair :: path_visited_lock_event_pairs in
-                  iter_lock new_path_visited_locks new_path_visited_lock_event_pairs' to_lock
-                ) lock_event_pairs
-            ) (man.global lock)
-        end
+          else if on_stack.(j) then
+            lowlink.(i) <- min lowlink.(i) number.(j)
+        ) edges.(i);
+      if lowlink.(i) = number.(i) then (
+        let rec pop () =
+          match !stack with
+          | j :: rest ->
+            stack := rest;
+            on_stack.(j) <- false;
+            scc.(j) <- !sccs;
+            if j <> i then pop ()
+          | [] -> assert false
+        in
+        pop ();
+        incr sccs
+      )
+    in
+    for i = 0 to n - 1 do
+      if number.(i) < 0 then strongconnect i
+    done;
+
+    let report pairs =
+      (* normalize pairs such that we don't get the same cycle multiple times, starting from different events *)
+      let min = List.min ~cmp:LockEventPair.compare pairs in
+      let (mini, _) = List.findi (fun i x -> LockEventPair.equal min x) pairs in
+      let (init, tail) = List.split_at (mini + 1) pairs in
+      let normalized = tail @ init in
+      let msgs = List.concat_map (fun ((before_lock, before_node, before_access), (after_lock, after_node, after_access)) ->
+          [
+            (Pretty.dprintf "lock before: %a with %a" Lock.pretty before_lock MCPAccess.A.pretty before_access, Some (M.Location.Node before_node));
+            (Pretty.dprintf "lock after: %a with %a" Lock.pretty after_lock MCPAccess.A.pretty after_access, Some (M.Location.Node after_node));
+          ]
+        ) normalized
       in
+      M.msg_group Warning ~category:Deadlock "Locking order cycle" msgs
+    in
+
+    let mhp ((_, (_, _, access1)) as p1) ((_, (_, _, access2)) as p2) =
+      LockEventPair.equal p1 p2 || MCPAccess.A.may_race access1 access2
+    in
+    let budget = ref (GobConfig.get_int "ana.deadlock.max-cycles") in
+    (* choose lock event pairs along cycle edges, checking MHP with previously chosen ones *)
+    let rec choose chosen = function
+      | [] -> report (List.rev chosen)
+      | pairs :: rest ->
+        MayLockEventPairs.iter (fun p ->
+            if List.for_all (mhp p) chosen then
+              choose (p :: chosen) rest
+          ) pairs
+    in
+    let cycle cycle_locks =
+      (* cycles of only checked locks have been reported by an earlier exploration *)
+      if List.exists (fun i -> not (LH.mem checked locks.(i))) cycle_locks then (
+        decr budget;
+        let cycle_edges = List.map2 (fun i j -> IM.find j edges.(i)) cycle_locks (List.tl cycle_locks @ [List.hd cycle_locks]) in
+        choose [] cycle_edges
+      )
+    in
+
+    (* Johnson's elementary cycles in non-trivial SCCs, each from its least index *)
+    let blocked = Array.make n false in
+    let blocked_by = Array.make n [] in
+    let rec unblock i =
+      blocked.(i) <- false;
+      let b = blocked_by.(i) in
+      blocked_by.(i) <- [];
+      List.iter (fun j -> if blocked.(j) then unblock j) b
+    in
+    let rec circuit s path i =
+      blocked.(i) <- true;
+      let found = ref false in
+      let path = i :: path in
+      IM.iter (fun j _ ->
+          if !budget > 0 && scc.(j) = scc.(s) && j >= s then (
+            if j = s then (
+              cycle (List.rev path);
+              found := true
+            )
+            else if not blocked.(j) && circuit s path j then
+              found := true
+          )
+        ) edges.(i);
+      if !found then
+        unblock i
+      else
+        IM.iter (fun j _ ->
+            if scc.(j) = scc.(s) && j >= s && not (List.mem i blocked_by.(j)) then
+              blocked_by.(j) <- i :: blocked_by.(j)
+          ) edges.(i);
+      !found
+    in
+    let scc_size = Array.make !sccs 0 in
+    let scc_unchecked = Array.make !sccs false in (* an SCC with an unchecked lock may have new cycles through any of its locks *)
+    Array.iteri (fun i c ->
+        scc_size.(c) <- scc_size.(c) + 1;
+        if not (LH.mem checked locks.(i)) then
+          scc_unchecked.(c) <- true
+      ) scc;
+    for s = 0 to n - 1 do
+      let nontrivial = scc_size.(scc.(s)) > 1 || IM.mem s edges.(s) in
+      if nontrivial && !budget > 0 && scc_unchecked.(scc.(s)) then (
+        for i = s to n - 1 do
+          if scc.(i) = scc.(s) then (
+            blocked.(i) <- false;
+            blocked_by.(i) <- []
+          )
+        done;
+        ignore (circuit s [] s)
+      )
+    done;
+    if !budget <= 0 then
+      M.info_noloc ~category:Deadlock "Locking order cycle enumeration reached ana.deadlock.max-cycles, some cycles may not be reported";
+    Array.iter (fun l -> LH.replace checked l ()) locks
 
-      Timing.wrap ~args:[("lock", `String (Lock.show g))] "deadlock" (iter_lock LS.empty []) g
+  let query man (type a) (q: a Queries.t): a Queries.result =
+    match q with
+    | WarnGlobal g ->
+      let g: V.t = Obj.obj g in
+      if not (LH.mem checked g) then
+        Timing.wrap ~args:[("lock", `String (Lock.show g))] "deadlock" (warn_cycles man) g
     | _ -> Queries.Result.top q
 end
 
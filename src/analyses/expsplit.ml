@@ -12,7 +12,8 @@ module Spec : Analyses.MCPSpec =
 struct
   let name () = "expsplit"
 
-  module D = MapDomain.MapBot (Basetype.CilExp) (ID)
+  module Exp = Basetype.InternedExp
+  module D = MapDomain.MapBot (Exp) (ID)
   include Analyses.ValueContexts(D)
 
   let startstate v = D.bot ()
@@ -23,7 +24,7 @@ struct
 
   let emit_splits man d =
     D.iter (fun e _ ->
-        man.emit (UpdateExpSplit e)
+        man.emit (UpdateExpSplit (Exp.to_exp e))
       ) d;
     d
 
@@ -61,10 +62,10 @@ struct
         let exp = List.hd arglist in
         let ik = Cilfacade.get_ikind_exp exp in
         (* TODO: something different for pointers, currently casts pointers to ints and loses precision (other than NULL) *)
-        D.add exp (ID.top_of ik) man.local (* split immediately follows *)
+        D.add (Exp.of_exp exp) (ID.top_of ik) man.local (* split immediately follows *)
       | _, "__goblint_split_end" ->
         let exp = List.hd arglist in
-        D.remove exp man.local
+        D.remove (Exp.of_exp exp) man.local
       | Setjmp { env }, _ ->
         Option.map_default (fun lval ->
             match GobConfig.get_string "ana.setjmp.split" with
@@ -72,11 +73,11 @@ struct
             | "precise" ->
               let e = Lval lval in
               let ik = Cilfacade.get_ikind_exp e in
-              D.add e (ID.top_of ik) man.local
+              D.add (Exp.of_exp e) (ID.top_of ik) man.local
             | "coarse" ->
               let e = Lval lval in
               let e = BinOp (Eq, e, integer 0, intType) in
-              D.add e (ID.top_of IInt) man.local
+              D.add (Exp.of_exp e) (ID.top_of IInt) man.local
             | _ -> failwith "Invalid value for ana.setjmp.split"
           ) man.local lval
       | _ ->
@@ -93,7 +94,7 @@ struct
     match event with
     | UpdateExpSplit exp ->
       let value = man.ask (EvalInt exp) in
-      D.add exp value man.local
+      D.add (Exp.of_exp exp) value man.local
     | Longjmped _ ->
       emit_splits_man man
     | _ ->
@@ -298,7 +298,7 @@ struct
           | Queries.WarnGlobal g ->
             (* WarnGlobal is special: it only goes to corresponding analysis and the argument variant is unlifted for it *)
             let (n, g): V.t = Obj.obj g in
-            f ~q:(WarnGlobal (Obj.repr g)) (Result.top ()) (n, spec n, assoc n man.local)
+            Timing.wrap (find_spec_name n) (f ~q:(WarnGlobal (Obj.repr g)) (Result.top ())) (n, spec n, assoc n man.local)
           | Queries.InvariantGlobal g ->
             (* InvariantGlobal is special: it only goes to corresponding analysis and the argument variant is unlifted for it *)
             let (n, g): V.t = Obj.obj g in
@@ -316,6 +316,17 @@ struct
                 let q' = Queries.IterSysVars (vq, fi') in
                 f ~q:q' () t
               ) @@ spec_list man.local
+          | Queries.IterLocalComponents fc ->
+            (* IterLocalComponents is special: components are named by analysis *)
+            iter (fun (n, d) -> fc (find_spec_name n ^ ".D") d) man.local;
+            begin match man.context () with
+              | c -> iter (fun (n, c) -> fc (find_spec_name n ^ ".C") c) c
+              | exception Man_failure _ -> () (* no context, e.g. at node *)
+            end
+          | Queries.IterGlobalComponents (g, fc) ->
+            (* IterGlobalComponents is special: global is named by its analysis *)
+            let v: V.t = Obj.obj g in
+            fc (find_spec_name (fst v) ^ ".G") (Obj.repr (man.global v))
           (* | EvalInt e ->
              (* TODO: only query others that actually respond to EvalInt *)
              (* 2x speed difference on SV-COMP nla-digbench-scaling/ps6-ll_valuebound5.c *)
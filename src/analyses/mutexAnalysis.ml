@@ -196,6 +196,16 @@ struct
     num_mutexes := 0;
     sum_protected := 0
 
+  let () =
+    ForkPool.register
+      ~reset:(fun () -> init ())
+      ~get:(fun () -> (!max_protected, !num_mutexes, !sum_protected))
+      ~merge:(fun (m, n, s) ->
+          max_protected := max !max_protected m;
+          num_mutexes := !num_mutexes + n;
+          sum_protected := !sum_protected + s
+        )
+
   let query (man: (D.t, _, _, V.t) man) (type a) (q: a Queries.t): a Queries.result =
     let ls, m = man.local in
     (* get the set of mutexes protecting the variable v in the given mode *)
@@ -217,6 +217,16 @@ struct
     vulnerable := 0;
     unsafe := 0
 
+  let () =
+    ForkPool.register
+      ~reset:(fun () -> init ())
+      ~get:(fun () -> (!safe, !vulnerable, !unsafe))
+      ~merge:(fun (s, v, u) ->
+          safe := !safe + s;
+          vulnerable := !vulnerable + v;
+          unsafe := !unsafe + u
+        )
+
   let side_vars man memo =
     match memo with
     | (`Var v, _) ->
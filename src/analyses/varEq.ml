@@ -19,13 +19,14 @@ struct
 
     let invariant ~scope ss =
       fold (fun s a ->
-          if B.mem MyCFG.unknown_exp s then
+          if B.mem (Exp.of_exp MyCFG.unknown_exp) s then
             a
           else
             let module B_prod = BatSet.Make2 (Exp) (Exp) in
             let s_prod = B_prod.cartesian_product s s in
             let i = B_prod.Product.fold (fun (x, y) a ->
-                if Exp.compare x y < 0 && not (InvariantCil.exp_contains_tmp x) && not (InvariantCil.exp_contains_tmp y) && InvariantCil.exp_is_in_scope scope x && InvariantCil.exp_is_in_scope scope y then (* each equality only one way, no self-equalities *)
+                let x = Exp.to_exp x and y = Exp.to_exp y in
+                if CilType.Exp.compare x y < 0 && not (InvariantCil.exp_contains_tmp x) && not (InvariantCil.exp_contains_tmp y) && InvariantCil.exp_is_in_scope scope x && InvariantCil.exp_is_in_scope scope y then (* each equality only one way, no self-equalities *)
                   let eq = BinOp (Eq, x, y, intType) in
                   Invariant.(a && of_exp eq)
                 else
@@ -94,7 +95,7 @@ struct
     let e2 = constFold false (stripCasts e2) in
     if exp_equal e1 e2 then true else
       match D.find_class e1 s with
-      | Some ss when D.B.mem e2 ss -> true
+      | Some ss when D.B.mem (D.Exp.of_exp e2) ss -> true
       | _ -> false
 
   (* kill predicate for must-equality kind of analyses*)
@@ -509,7 +510,7 @@ struct
     | Some es ->
       let et = Cilfacade.typeOf e in
       let add x xs =
-        Queries.ES.add (CastE (et,x)) xs
+        Queries.ES.add (CastE (et, D.Exp.to_exp x)) xs
       in
       D.B.fold add es (Queries.ES.empty ())
 
@@ -185,7 +185,14 @@ struct
   (* Hoare set for bucket doesn't play well with StrPtr limiting:
      https://github.com/goblint/analyzer/pull/808 *)
   module AddressSet: SetDomain.S with type elt = Addr.t = DisjointDomain.ProjectiveSet (Addr) (OffsetSplit) (Addr.VariableRepr)
-  include AddressSet
+  module HConsedArg =
+  struct
+    let name = "address set"
+    let enabled = Lazy.from_fun (fun () -> GobConfig.get_bool "ana.opt.hashcons-values")
+    let enabled () = Lazy.force enabled
+    let memo_size = 16384
+  end
+  include SetDomain.HConsedOpt (AddressSet) (HConsedArg)
 
   let name () = Format.sprintf "address set (%s)" (Mval.name ())
 
@@ -7,7 +7,7 @@ module M = Messages
 module A = Array
 module VDQ = ValueDomainQueries
 
-type domain = TrivialDomain | PartitionedDomain | UnrolledDomain
+type domain = TrivialDomain | PartitionedDomain | UnrolledDomain | SegmentedDomain
 
 (* determines the domain based on variable, type and flag *)
 let get_domain ~varAttr ~typAttr =
@@ -15,6 +15,7 @@ let get_domain ~varAttr ~typAttr =
     | "partitioned" -> PartitionedDomain
     | "trivial" -> TrivialDomain
     | "unroll" ->  UnrolledDomain
+    | "segmented" -> SegmentedDomain
     | _ -> failwith "AttributeConfiguredArrayDomain: invalid option for domain"
   in
   (*TODO add options?*)
@@ -998,6 +999,218 @@ struct
   let to_yojson (x, y) = `Assoc [ (Base.name (), Base.to_yojson x); ("length", Idx.to_yojson y) ]
 end
 
+let max_segments () = get_int "ana.base.arrays.segments"
+
+(** Array as a sorted map from the start index of each segment to the value of its elements.
+    Segments are disjoint and cover all indices: each one extends to the start of the next one, the last one unboundedly.
+    Adjacent segments with equal values are merged and the number of segments is bounded by [ana.base.arrays.segments]. *)
+module Segmented (Val: LatticeWithInvalidate) (Idx: IntDomain.Z): S with type value = Val.t and type idx = Idx.t =
+struct
+  include Printable.Std
+  module ZMap = Map.Make (Z)
+  type t = Val.t ZMap.t (* always contains 0 *)
+  type idx = Idx.t
+  type value = Val.t
+
+  let name () = "segmented arrays"
+  let domain_of_t _ = SegmentedDomain
+
+  let equal = ZMap.equal Val.equal
+  let compare = ZMap.compare Val.compare
+  let hash x = ZMap.fold (fun i v acc -> 31 * acc + 13 * Z.hash i + Val.hash v) x 0
+  let relift x = ZMap.map Val.relift x
+
+  (** Array from sorted segments, the first of which starts at 0. *)
+  let of_segments segments =
+    let rec merge = function
+      | (i, v) :: (_, v') :: segments when Val.equal v v' -> merge ((i, v) :: segments)
+      | s :: segments -> s :: merge segments
+      | [] -> []
+    in
+    let segments = merge segments in
+    let limit = max 1 (max_segments ()) in
+    let segments =
+      if List.length segments > limit then (
+        (* join the rightmost segments, which are the least likely to be initialized *)
+        let (kept, joined) = BatList.takedrop (limit - 1) segments in
+        match joined with
+        | (i, _) :: _ -> kept @ [(i, List.fold_left (fun acc (_, v) -> Val.join acc v) (Val.bot ()) joined)]
+        | [] -> kept
+      )
+      else
+        segments
+    in
+    ZMap.of_seq (List.to_seq segments)
+
+  let value_at x i = snd (ZMap.find_last (fun j -> Z.leq j i) x)
+
+  (** Join of the values of all segments overlapping indices from [lo] to [hi], which is [None] if unbounded. *)
+  let range_value x lo hi =
+    let first = fst (ZMap.find_last (fun j -> Z.leq j lo) x) in
+    ZMap.to_seq_from first x
+    |> Seq.take_while (fun (i, _) -> GobOption.for_all (Z.leq i) hi)
+    |> Seq.fold_left (fun acc (_, v) -> Val.join acc v) (Val.bot ())
+
+  (** Starts of segments of both arrays. *)
+  let common_starts x y =
+    List.sort_uniq Z.compare (List.rev_append (List.map fst (ZMap.bindings x)) (List.map fst (ZMap.bindings y)))
+
+  let pointwise op x y =
+    of_segments (List.map (fun i -> (i, op (value_at x i) (value_at y i))) (common_starts x y))
+
+  let bot () = ZMap.singleton Z.zero (Val.bot ())
+  let top () = ZMap.singleton Z.zero (Val.top ())
+  let is_bot x = ZMap.for_all (fun _ v -> Val.is_bot v) x
+  let is_top x = ZMap.for_all (fun _ v -> Val.is_top v) x
+
+  let leq x y = List.for_all (fun i -> Val.leq (value_at x i) (value_at y i)) (common_starts x y)
+  let join x y = if x == y then x else pointwise Val.join x y
+  let meet x y = pointwise Val.meet x y
+  let narrow x y = pointwise Val.narrow x y
+
+  (* Keeps the segments of x, such that the segments cannot be refined indefinitely. *)
+  let widen x y =
+    let rec widen_segments = function
+      | (i, v) :: ((i', _) :: _ as segments) -> (i, Val.widen v (Val.join v (range_value y i (Some (Z.pred i'))))) :: widen_segments segments
+      | [(i, v)] -> [(i, Val.widen v (Val.join v (range_value y i None)))]
+      | [] -> []
+    in
+    of_segments (widen_segments (ZMap.bindings x))
+
+  let show_segment (i, v) next =
+    match next with
+    | Some i' when Z.equal (Z.succ i) i' -> Printf.sprintf "[%s]: %s" (Z.to_string i) (Val.show v)
+    | Some i' -> Printf.sprintf "[%s..%s]: %s" (Z.to_string i) (Z.to_string (Z.pred i')) (Val.show v)
+    | None -> Printf.sprintf "[%s..]: %s" (Z.to_string i) (Val.show v)
+
+  let fold_segments f x acc =
+    let rec fold acc = function
+      | s :: ((i', _) :: _ as segments) -> fold (f s (Some i') acc) segments
+      | [s] -> f s None acc
+      | [] -> acc
+    in
+    fold acc (ZMap.bindings x)
+
+  let show x = "Array: " ^ String.concat ", " (List.rev (fold_segments (fun s next acc -> show_segment s next :: acc) x []))
+  let pretty () x = text (show x)
+  let pretty_diff () (x,y) = dprintf "%s: %a not leq %a" (name ()) pretty x pretty y
+  let printXml f x =
+    BatPrintf.fprintf f "<value>\n<map>\n";
+    fold_segments (fun (i, v) next () ->
+        let key = match next with
+          | Some i' -> Printf.sprintf "%s..%s" (Z.to_string i) (Z.to_string (Z.pred i'))
+          | None -> Printf.sprintf "%s.." (Z.to_string i)
+        in
+        BatPrintf.fprintf f "<key>\n%s\n</key>\n%a" key Val.printXml v
+      ) x ();
+    BatPrintf.fprintf f "</map>\n</value>\n"
+  let to_yojson x = `List (List.map (fun (i, v) -> `List [`String (Z.to_string i); Val.to_yojson v]) (ZMap.bindings x))
+
+  (** Bounds of an index, clipped to non-negative. *)
+  let bounds i =
+    let lo = Z.max Z.zero (BatOption.default Z.zero (Idx.minimal i)) in
+    let hi = BatOption.map (Z.max lo) (Idx.maximal i) in
+    (lo, hi)
+
+  let get ?(checkBounds=true) (ask: VDQ.t) x (_, i) =
+    let (lo, hi) = bounds i in
+    range_value x lo hi
+
+  let split i x = if ZMap.mem i x then x else ZMap.add i (value_at x i) x
+
+  let set (ask: VDQ.t) x (ie, i) v =
+    match ie with
+    | Some ie when CilType.Exp.equal ie (Lazy.force Offset.Index.Exp.all) ->
+      ZMap.singleton Z.zero v
+    | _ ->
+      match bounds i with
+      | (lo, Some hi) when Z.equal lo hi -> (* strong update of a single element *)
+        let x = split lo (split (Z.succ lo) x) in
+        of_segments (ZMap.bindings (ZMap.add lo v x))
+      | (lo, hi) -> (* weak update of all segments in range *)
+        let x = split lo (BatOption.map_default (fun hi -> split (Z.succ hi) x) x hi) in
+        let in_range j = Z.geq j lo && GobOption.for_all (Z.leq j) hi in
+        of_segments (ZMap.bindings (ZMap.mapi (fun j w -> if in_range j then Val.join w v else w) x))
+
+  let make ?(varAttr=[]) ?(typAttr=[]) _ v = ZMap.singleton Z.zero v
+  let length _ = None
+  let move_if_affected ?(replace_with_const=false) _ x _ _ = x
+  let get_vars_in_e _ = []
+  let map f x = of_segments (List.map (fun (i, v) -> (i, f v)) (ZMap.bindings x))
+  let fold_left f a x = ZMap.fold (fun _ v acc -> f acc v) x a
+  let smart_join _ _ = join
+  let smart_widen _ _ = widen
+  let smart_leq _ _ = leq
+  let update_length _ x = x
+  let project ?(varAttr=[]) ?(typAttr=[]) _ t = t
+
+  let invariant ~value_invariant ~offset ~lval x =
+    match offset with
+    (* invariants for all indices *)
+    | NoOffset ->
+      let i_all =
+        if get_bool "witness.invariant.goblint" then (
+          let i_lval = Cil.addOffsetLval (Index (Lazy.force Offset.Index.Exp.all, NoOffset)) lval in
+          value_invariant ~offset ~lval:i_lval (fold_left Val.join (Val.bot ()) x)
+        )
+        else
+          Invariant.top ()
+      in
+      (* invariants for segments of single elements *)
+      fold_segments (fun (i, v) next acc ->
+          match next with
+          | Some i' when Z.equal (Z.succ i) i' && not (Val.is_bot v) ->
+            let i_lval = Cil.addOffsetLval (Index (Cil.kintegerCilint (Cilfacade.ptrdiff_ikind ()) i, NoOffset)) lval in
+            Invariant.(acc && value_invariant ~offset ~lval:i_lval v)
+          | _ -> acc
+        ) x i_all
+    (* invariant for one index *)
+    | Index (i, offset) ->
+      Invariant.none (* TODO: look up *)
+    (* invariant for one field *)
+    | Field (f, offset) ->
+      Invariant.none
+end
+
+module SegmentedWithLength (Val: LatticeWithInvalidate) (Idx: IntDomain.Z): S with type value = Val.t and type idx = Idx.t =
+struct
+  module Base = Segmented (Val) (Idx)
+  include Lattice.Prod (Base) (Idx)
+  type idx = Idx.t
+  type value = Val.t
+
+  let domain_of_t _ = SegmentedDomain
+
+  let get ?(checkBounds=true) (ask : VDQ.t) (x, (l : idx)) (e, v) =
+    if checkBounds then (array_oob_check (module Idx) (x, l) (e, v));
+    Base.get ask x (e, v)
+  let set (ask: VDQ.t) (x,l) i v = Base.set ask x i v, l
+  let make ?(varAttr=[]) ?(typAttr=[]) l x = Base.make l x, l
+  let length (_,l) = Some l
+
+  let move_if_affected ?(replace_with_const=false) _ x _ _ = x
+  let map f (x, l):t = (Base.map f x, l)
+  let fold_left f a (x, l) = Base.fold_left f a x
+  let get_vars_in_e _ = []
+
+  let smart_join _ _ = join
+  let smart_widen _ _ = widen
+  let smart_leq _ _ = leq
+
+  (* See TrivialWithLength. *)
+  let update_length newl (x, l) = (x, newl)
+
+  let project ?(varAttr=[]) ?(typAttr=[]) _ t = t
+
+  let invariant ~value_invariant ~offset ~lval (x, _) =
+    Base.invariant ~value_invariant ~offset ~lval x
+
+  let printXml f (x,y) =
+    BatPrintf.fprintf f "<value>\n<map>\n<key>\n%s\n</key>\n%a<key>\n%s\n</key>\n%a</map>\n</value>\n" (XmlUtil.escape (Base.name ())) Base.printXml x "length" Idx.printXml y
+
+  let to_yojson (x, y) = `Assoc [ (Base.name (), Base.to_yojson x); ("length", Idx.to_yojson y) ]
+end
+
 module NullByte (Val: LatticeWithNull) (Idx: IntDomain.Z): Str with type value = Val.t and type idx = Idx.t =
 struct
   module MustSet = NullByteSet.MustSet
@@ -1671,6 +1884,7 @@ struct
   module P = PartitionedWithLength(Val)(Idx)
   module T = TrivialWithLength(Val)(Idx)
   module U = UnrollWithLength(Val)(Idx)
+  module S = SegmentedWithLength(Val)(Idx)
 
   type idx = Idx.t
   type value = Val.t
@@ -1681,24 +1895,27 @@ struct
   end
 
   let to_t = function
-    | (Some p, None, None) -> (Some p, None)
-    | (None, Some t, None) -> (None, Some (Some t, None))
-    | (None, None, Some u) -> (None, Some (None, Some u))
+    | (Some p, None, None, None) -> (Some p, None)
+    | (None, Some t, None, None) -> (None, Some (Some t, None))
+    | (None, None, Some u, None) -> (None, Some (None, Some (Some u, None)))
+    | (None, None, None, Some s) -> (None, Some (None, Some (None, Some s)))
     | _ -> failwith "AttributeConfiguredArrayDomain received a value where not exactly one component is set"
 
-  module I = struct include LatticeFlagHelper (T) (U) (K) let name () = "" end
+  module J = struct include LatticeFlagHelper (U) (S) (K) let name () = "" end
+  module I = struct include LatticeFlagHelper (T) (J) (K) let name () = "" end
   include LatticeFlagHelper (P) (I) (K)
 
   let domain_of_t = function
     | (Some p, None) -> PartitionedDomain
     | (None, Some (Some t, None)) -> TrivialDomain
-    | (None, Some (None, Some u)) -> UnrolledDomain
+    | (None, Some (None, Some (Some u, None))) -> UnrolledDomain
+    | (None, Some (None, Some (None, Some s))) -> SegmentedDomain
     | _ -> failwith "Array of invalid domain"
 
-  let binop' opp opt opu = binop opp (I.binop opt opu)
-  let unop' opp opt opu = unop opp (I.unop opt opu)
-  let binop_to_t' opp opt opu = binop_to_t opp (I.binop_to_t opt opu)
-  let unop_to_t' opp opt opu = unop_to_t opp (I.unop_to_t opt opu)
+  let binop' opp opt opu ops = binop opp (I.binop opt (J.binop opu ops))
+  let unop' opp opt opu ops = unop opp (I.unop opt (J.unop opu ops))
+  let binop_to_t' opp opt opu ops = binop_to_t opp (I.binop_to_t opt (J.binop_to_t opu ops))
+  let unop_to_t' opp opt opu ops = unop_to_t opp (I.unop_to_t opt (J.unop_to_t opu ops))
 
   (* Simply call appropriate function for component that is not None *)
   let get ?(checkBounds=true) a x (e,i) = unop' (fun x ->
@@ -1707,34 +1924,37 @@ struct
         P.get ~checkBounds a x (e', i)
       else
         P.get ~checkBounds a x (e, i)
-    ) (fun x -> T.get ~checkBounds a x (e,i)) (fun x -> U.get ~checkBounds a x (e,i)) x
-  let set (ask:VDQ.t) x i a = unop_to_t' (fun x -> P.set ask x i a) (fun x -> T.set ask x i a) (fun x -> U.set ask x i a) x
-  let length = unop' P.length T.length U.length
-  let map f = unop_to_t' (P.map f) (T.map f) (U.map f)
-  let fold_left f s = unop' (P.fold_left f s) (T.fold_left f s) (U.fold_left f s)
-
-  let move_if_affected ?(replace_with_const=false) (ask:VDQ.t) x v f = unop_to_t' (fun x -> P.move_if_affected ~replace_with_const:replace_with_const ask x v f) (fun x -> T.move_if_affected ~replace_with_const:replace_with_const ask x v f) (fun x -> U.move_if_affected ~replace_with_const:replace_with_const ask x v f) x
-  let get_vars_in_e = unop' P.get_vars_in_e T.get_vars_in_e U.get_vars_in_e
-  let smart_join f g = binop_to_t' (P.smart_join f g) (T.smart_join f g) (U.smart_join f g)
-  let smart_widen f g =  binop_to_t' (P.smart_widen f g) (T.smart_widen f g) (U.smart_widen f g)
-  let smart_leq f g = binop' (P.smart_leq f g) (T.smart_leq f g) (U.smart_leq f g)
-  let update_length newl x = unop_to_t' (P.update_length newl) (T.update_length newl) (U.update_length newl) x
+    ) (fun x -> T.get ~checkBounds a x (e,i)) (fun x -> U.get ~checkBounds a x (e,i)) (fun x -> S.get ~checkBounds a x (e,i)) x
+  let set (ask:VDQ.t) x i a = unop_to_t' (fun x -> P.set ask x i a) (fun x -> T.set ask x i a) (fun x -> U.set ask x i a) (fun x -> S.set ask x i a) x
+  let length = unop' P.length T.length U.length S.length
+  let map f = unop_to_t' (P.map f) (T.map f) (U.map f) (S.map f)
+  let fold_left f s = unop' (P.fold_left f s) (T.fold_left f s) (U.fold_left f s) (S.fold_left f s)
+
+  let move_if_affected ?(replace_with_const=false) (ask:VDQ.t) x v f = unop_to_t' (fun x -> P.move_if_affected ~replace_with_const:replace_with_const ask x v f) (fun x -> T.move_if_affected ~replace_with_const:replace_with_const ask x v f) (fun x -> U.move_if_affected ~replace_with_const:replace_with_const ask x v f) (fun x -> S.move_if_affected ~replace_with_const:replace_with_const ask x v f) x
+  let get_vars_in_e = unop' P.get_vars_in_e T.get_vars_in_e U.get_vars_in_e S.get_vars_in_e
+  let smart_join f g = binop_to_t' (P.smart_join f g) (T.smart_join f g) (U.smart_join f g) (S.smart_join f g)
+  let smart_widen f g =  binop_to_t' (P.smart_widen f g) (T.smart_widen f g) (U.smart_widen f g) (S.smart_widen f g)
+  let smart_leq f g = binop' (P.smart_leq f g) (T.smart_leq f g) (U.smart_leq f g) (S.smart_leq f g)
+  let update_length newl x = unop_to_t' (P.update_length newl) (T.update_length newl) (U.update_length newl) (S.update_length newl) x
   let name () = "FlagHelperAttributeConfiguredArrayDomain"
 
   let bot () = to_t @@ match get_domain ~varAttr:[] ~typAttr:[] with
-    | PartitionedDomain -> (Some (P.bot ()), None, None)
-    | TrivialDomain -> (None, Some (T.bot ()), None)
-    | UnrolledDomain ->  (None, None, Some (U.bot ()))
+    | PartitionedDomain -> (Some (P.bot ()), None, None, None)
+    | TrivialDomain -> (None, Some (T.bot ()), None, None)
+    | UnrolledDomain ->  (None, None, Some (U.bot ()), None)
+    | SegmentedDomain -> (None, None, None, Some (S.bot ()))
 
   let top () = to_t @@ match get_domain ~varAttr:[] ~typAttr:[] with
-    | PartitionedDomain -> (Some (P.top ()), None, None)
-    | TrivialDomain -> (None, Some (T.top ()), None)
-    | UnrolledDomain -> (None, None, Some (U.top ()))
+    | PartitionedDomain -> (Some (P.top ()), None, None, None)
+    | TrivialDomain -> (None, Some (T.top ()), None, None)
+    | UnrolledDomain -> (None, None, Some (U.top ()), None)
+    | SegmentedDomain -> (None, None, None, Some (S.top ()))
 
   let make ?(varAttr=[]) ?(typAttr=[]) i v = to_t @@  match get_domain ~varAttr ~typAttr with
-    | PartitionedDomain -> (Some (P.make i v), None, None)
-    | TrivialDomain -> (None, Some (T.make i v), None)
-    | UnrolledDomain -> (None, None, Some (U.make i v))
+    | PartitionedDomain -> (Some (P.make i v), None, None, None)
+    | TrivialDomain -> (None, Some (T.make i v), None, None)
+    | UnrolledDomain -> (None, None, Some (U.make i v), None)
+    | SegmentedDomain -> (None, None, None, Some (S.make i v))
 
   (* convert to another domain *)
   let index_as_expression i = (Some (Cil.integer i), Idx.of_int IInt (Z.of_int i))
@@ -1768,17 +1988,45 @@ struct
     let set_i u (i,v) =  U.set ask u (index_as_expression i) v in
     set_i (List.fold_left set_i u unrolledValues) (factor (), rest)
 
+  (* Segmented arrays can represent any other array by its elements, only unrolled and partitioned arrays lose the precise positions. *)
+  let segmented_of_trivial ask t = S.make (Option.value (T.length t) ~default:(Idx.top ())) (T.get ~checkBounds:false ask t (index_as_expression 0))
+
+  let segmented_of_partitioned ask p = S.make (Option.value (P.length p) ~default:(Idx.top ())) (P.get ~checkBounds:false ask p (None, Idx.top ()))
+
+  let segmented_of_unroll ask u =
+    let rest = U.get ~checkBounds:false ask u (index_as_expression (factor ())) in
+    let s = S.make (Option.value (U.length u) ~default:(Idx.top ())) rest in
+    let set_i s i = S.set ask s (index_as_expression i) (U.get ~checkBounds:false ask u (index_as_expression i)) in
+    List.fold_left set_i s @@ List.init (factor ()) Fun.id
+
+  let trivial_of_segmented ask s = T.make (Option.value (S.length s) ~default:(Idx.top ())) (S.get ~checkBounds:false ask s (None, Idx.top ()))
+
+  let partitioned_of_segmented ask s = P.make (Option.value (S.length s) ~default:(Idx.top ())) (S.get ~checkBounds:false ask s (None, Idx.top ()))
+
+  let unroll_of_segmented ask s =
+    let rest = S.get ~checkBounds:false ask s (None, Idx.starting (Cilfacade.ptrdiff_ikind ()) (Z.of_int (factor ()))) in
+    let u = U.make (Option.value (S.length s) ~default:(Idx.top ())) (Val.bot ()) in
+    let set_i u i = U.set ask u (index_as_expression i) (S.get ~checkBounds:false ask s (index_as_expression i)) in
+    U.set ask (List.fold_left set_i u @@ List.init (factor ()) Fun.id) (index_as_expression (factor ())) rest
+
   let project ?(varAttr=[]) ?(typAttr=[]) ask (t:t) =
     match get_domain ~varAttr ~typAttr, t with
-    | PartitionedDomain, (Some x, None) -> to_t @@ (Some x, None, None)
-    | PartitionedDomain, (None, Some (Some x, None)) -> to_t @@ (Some (partitioned_of_trivial ask x), None, None)
-    | PartitionedDomain, (None, Some (None, Some x)) -> to_t @@ (Some (partitioned_of_unroll ask x), None, None)
-    | TrivialDomain, (Some x, None) -> to_t @@ (None, Some (trivial_of_partitioned ask x), None)
-    | TrivialDomain, (None, Some (Some x, None)) -> to_t @@ (None, Some x, None)
-    | TrivialDomain, (None, Some (None, Some x)) -> to_t @@ (None, Some (trivial_of_unroll ask x), None)
-    | UnrolledDomain, (Some x, None) -> to_t @@ (None, None, Some (unroll_of_partitioned ask x) )
-    | UnrolledDomain, (None, Some (Some x, None)) -> to_t @@ (None, None, Some (unroll_of_trivial ask x) )
-    | UnrolledDomain, (None, Some (None, Some x)) -> to_t @@ (None, None, Some x)
+    | PartitionedDomain, (Some x, None) -> to_t @@ (Some x, None, None, None)
+    | PartitionedDomain, (None, Some (Some x, None)) -> to_t @@ (Some (partitioned_of_trivial ask x), None, None, None)
+    | PartitionedDomain, (None, Some (None, Some (Some x, None))) -> to_t @@ (Some (partitioned_of_unroll ask x), None, None, None)
+    | PartitionedDomain, (None, Some (None, Some (None, Some x))) -> to_t @@ (Some (partitioned_of_segmented ask x), None, None, None)
+    | TrivialDomain, (Some x, None) -> to_t @@ (None, Some (trivial_of_partitioned ask x), None, None)
+    | TrivialDomain, (None, Some (Some x, None)) -> to_t @@ (None, Some x, None, None)
+    | TrivialDomain, (None, Some (None, Some (Some x, None))) -> to_t @@ (None, Some (trivial_of_unroll ask x), None, None)
+    | TrivialDomain, (None, Some (None, Some (None, Some x))) -> to_t @@ (None, Some (trivial_of_segmented ask x), None, None)
+    | UnrolledDomain, (Some x, None) -> to_t @@ (None, None, Some (unroll_of_partitioned ask x), None)
+    | UnrolledDomain, (None, Some (Some x, None)) -> to_t @@ (None, None, Some (unroll_of_trivial ask x), None)
+    | UnrolledDomain, (None, Some (None, Some (Some x, None))) -> to_t @@ (None, None, Some x, None)
+    | UnrolledDomain, (None, Some (None, Some (None, Some x))) -> to_t @@ (None, None, Some (unroll_of_segmented ask x), None)
+    | SegmentedDomain, (Some x, None) -> to_t @@ (None, None, None, Some (segmented_of_partitioned ask x))
+    | SegmentedDomain, (None, Some (Some x, None)) -> to_t @@ (None, None, None, Some (segmented_of_trivial ask x))
+    | SegmentedDomain, (None, Some (None, Some (Some x, None))) -> to_t @@ (None, None, None, Some (segmented_of_unroll ask x))
+    | SegmentedDomain, (None, Some (None, Some (None, Some x))) -> to_t @@ (None, None, None, Some x)
     | _ ->  failwith "AttributeConfiguredArrayDomain received a value where not exactly one component is set"
 
   let invariant ~value_invariant ~offset ~lval =
@@ -1786,6 +2034,7 @@ struct
       (P.invariant ~value_invariant ~offset ~lval)
       (T.invariant ~value_invariant ~offset ~lval)
       (U.invariant ~value_invariant ~offset ~lval)
+      (S.invariant ~value_invariant ~offset ~lval)
 end
 
 module AttributeConfiguredAndNullByteArrayDomain (Val: LatticeWithNull) (Idx: IntDomain.Z): StrWithDomain with type value = Val.t and type idx = Idx.t =
@@ -4,7 +4,7 @@ open IntOps
 open GoblintCil
 module VDQ = ValueDomainQueries
 
-type domain = TrivialDomain | PartitionedDomain | UnrolledDomain
+type domain = TrivialDomain | PartitionedDomain | UnrolledDomain | SegmentedDomain
 
 val get_domain: varAttr:Cil.attributes -> typAttr:Cil.attributes -> domain
 (** gets the underlying domain: chosen by the attributes in AttributeConfiguredArrayDomain *)
@@ -171,7 +171,7 @@ module NullByte (Val: LatticeWithNull) (Idx: IntDomain.Z): Str with type value =
 *)
 
 module AttributeConfiguredArrayDomain (Val: LatticeWithSmartOps) (Idx: IntDomain.Z): S with type value = Val.t and type idx = Idx.t
-(** Switches between PartitionedWithLength, TrivialWithLength and Unroll based on variable, type, and flag. *)
+(** Switches between PartitionedWithLength, TrivialWithLength, Unroll and Segmented based on variable, type, and flag. *)
 
 module AttributeConfiguredAndNullByteArrayDomain (Val: LatticeWithNull) (Idx: IntDomain.Z): StrWithDomain with type value = Val.t and type idx = Idx.t
 (** Like FlagHelperAttributeConfiguredArrayDomain but additionally runs NullByte
@@ -38,6 +38,7 @@ sig
   val top_value: ?varAttr:attributes -> typ -> t
   val is_top_value: t -> typ -> bool
   val zero_init_value: ?varAttr:attributes -> typ -> t
+  val of_init: ?varAttr:attributes -> (exp -> t) -> typ -> init -> t
 
   include ArrayDomain.Null with type t := t
 
@@ -645,6 +646,41 @@ struct
       warn_type "widen" x y;
       Top
 
+  (** Value of an initializer, built directly from its tree instead of assigning each element.
+      Elements of arrays are joined, like assigning them to any index. *)
+  let rec of_init ?(varAttr=[]) (eval: exp -> t) (t: typ) (init: init): t =
+    match t, init with
+    | _, SingleInit e -> eval e
+    | TNamed ({ttype=t; _}, _), _ -> of_init ~varAttr eval t init
+    | TComp ({cstruct=true; _} as ci, _), CompoundInit (_, inits) ->
+      let field_init fd =
+        List.find_map (function
+            | (Field (fd', NoOffset), init) when CilType.Fieldinfo.equal fd fd' -> Some init
+            | _ -> None
+          ) inits
+      in
+      Struct (Structs.create (fun fd ->
+          match field_init fd with
+          | Some init -> of_init ~varAttr:fd.fattr eval fd.ftype init
+          | None -> zero_init_value ~varAttr:fd.fattr fd.ftype
+        ) ci)
+    | TComp ({cstruct=false; _}, _), CompoundInit (_, [(Field (fd, NoOffset), init)]) ->
+      Union (`Lifted fd, of_init ~varAttr:fd.fattr eval fd.ftype init)
+    | TArray (ai, length, _), CompoundInit (_, inits) ->
+      let typAttr = typeAttrs ai in
+      let len = array_length_idx (IndexDomain.top ()) length in
+      let implicit_zero = (* fewer initializers than elements *)
+        match BatOption.bind length (fun e -> Cil.getInteger (Cil.constFold true e)) with
+        | Some n -> Z.gt n (Z.of_int (List.length inits))
+        | None -> false
+      in
+      let value = List.fold_left (fun acc (_, init) ->
+          join acc (of_init eval ai init)
+        ) (if implicit_zero then zero_init_value ai else bot_value ai) inits
+      in
+      Array (CArrays.make ~varAttr ~typAttr len value)
+    | _, CompoundInit _ -> top_value ~varAttr t
+
   let rec smart_join x_eval_int y_eval_int  (x:t) (y:t):t =
     let join_elem: (t -> t -> t) = smart_join x_eval_int y_eval_int in  (* does not compile without type annotation *)
     match (x,y) with
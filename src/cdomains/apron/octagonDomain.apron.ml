@@ -0,0 +1,734 @@
+(** OCaml implementation of the octagon domain on difference-bound matrices ([octagon]).
+
+    @see <https://doi.org/10.1007/s10990-006-8609-1> A. Miné. The octagon abstract domain.
+    @see <https://doi.org/10.1016/j.tcs.2009.07.009> R. Bagnara, P. M. Hill, E. Zaffanella. Weakly-relational shapes for numeric abstractions: improved algorithms and proofs of correctness. *)
+
+(** Abstract states in this domain are represented by structs containing a difference-bound matrix (DBM) and an apron environment.
+    The DBM ranges over [+x] and [-x] for each variable [x] of the environment and is stored unboxed in a flat float array, where [infinity] means unbounded.
+    Except for results of widening, the DBM is kept tightly closed, such that inclusion, join and bounds can be read off pointwise.
+*)
+
+open Batteries
+open GoblintCil
+open Pretty
+module M = Messages
+open GobApron
+
+module Dbm =
+struct
+  (** Matrix over [2 * n] dimensions, where entry [(i, j)] bounds [v_j - v_i] with [v_2k = x_k] and [v_2k+1 = -x_k]. *)
+  type t = {
+    n: int;
+    m: float array;
+  }
+
+  let equal d1 d2 = d1.n = d2.n && d1.m = d2.m
+  let compare d1 d2 = Stdlib.compare (d1.n, d1.m) (d2.n, d2.m)
+  let hash d = Hashtbl.hash (d.n, d.m)
+
+  let copy d = {d with m = Array.copy d.m}
+
+  (** Bounds beyond this are not exactly representable by floats, so they are dropped instead. *)
+  let max_exact = 4503599627370496. (* 2^52 *)
+
+  let bound x = if Float.abs x > max_exact then infinity else x
+  let add a b = bound (a +. b)
+
+  let of_z z = if Z.numbits z > 52 then infinity else Z.to_float z
+  let to_z f = if f = infinity then None else Some (Z.of_float f)
+
+  let bar i = i lxor 1
+
+  (** Index of [s * x_k] for sign [s]. *)
+  let index k s = if s > 0 then 2 * k else 2 * k + 1
+
+  let top n =
+    let s = 2 * n in
+    let m = Array.make (s * s) infinity in
+    for i = 0 to s - 1 do
+      m.(i * s + i) <- 0.
+    done;
+    {n; m}
+
+  (** creates a DBM of dimension 0 *)
+  let empty () = top 0
+
+  let is_empty d = d.n = 0
+
+  let is_top d =
+    let s = 2 * d.n in
+    let exception NotTop in
+    try
+      for i = 0 to s - 1 do
+        for j = 0 to s - 1 do
+          if i <> j && d.m.(i * s + j) < infinity then
+            raise NotTop
+        done
+      done;
+      true
+    with NotTop -> false
+
+  let get d i j = d.m.(i * 2 * d.n + j)
+
+  (** Add [v_j - v_i <= c] and its coherent counterpart [v_i' - v_j' <= c] {e in-place}. *)
+  let add_constraint d i j c =
+    let s = 2 * d.n in
+    let c = bound c in
+    if c < d.m.(i * s + j) then
+      d.m.(i * s + j) <- c;
+    if c < d.m.(bar j * s + bar i) then
+      d.m.(bar j * s + bar i) <- c
+
+  (** Add [s * x_k <= c] {e in-place}. *)
+  let add_unary d k s c =
+    add_constraint d (index k (-s)) (index k s) (of_z (Z.mul (Z.of_int 2) c))
+
+  (** Add [s1 * x_k1 + s2 * x_k2 <= c] {e in-place}. *)
+  let add_binary d k1 s1 k2 s2 c =
+    add_constraint d (index k2 (-s2)) (index k1 s1) (of_z c)
+
+  (** Tight closure {e in-place} by shortest paths through [pivots], tightening and strengthening.
+      Closing through the indices of some variables suffices if the DBM was closed before constraints involving only those were added.
+      Returns [false] if the DBM is empty. *)
+  let close_with pivots d =
+    let s = 2 * d.n in
+    let m = d.m in
+    List.iter (fun k ->
+        let ks = k * s in
+        for i = 0 to s - 1 do
+          let is = i * s in
+          let mik = m.(is + k) in
+          if mik < infinity then
+            for j = 0 to s - 1 do
+              let v = add mik m.(ks + j) in
+              if v < m.(is + j) then
+                m.(is + j) <- v
+            done
+        done
+      ) pivots;
+    let consistent = ref true in
+    for i = 0 to s - 1 do
+      if m.(i * s + i) < 0. then
+        consistent := false
+    done;
+    if !consistent then (
+      (* tightening: integer variables have integer bounds *)
+      for i = 0 to s - 1 do
+        let ii = i * s + bar i in
+        m.(ii) <- 2. *. Float.floor (m.(ii) /. 2.)
+      done;
+      for i = 0 to s - 1 do
+        if m.(i * s + bar i) +. m.(bar i * s + i) < 0. then
+          consistent := false
+      done;
+      (* strengthening *)
+      if !consistent then (
+        for i = 0 to s - 1 do
+          let is = i * s in
+          let mii = m.(is + bar i) in
+          if mii < infinity then
+            for j = 0 to s - 1 do
+              let v = (mii +. m.(bar j * s + j)) /. 2. in
+              if v < m.(is + j) then
+                m.(is + j) <- v
+            done
+        done;
+        for i = 0 to s - 1 do
+          m.(i * s + i) <- 0.
+        done
+      )
+    );
+    !consistent
+
+  let close d = close_with (List.init (2 * d.n) Fun.id) d
+
+  (** Indices of variables to close through after adding constraints on them. *)
+  let pivots ks = List.concat_map (fun k -> [2 * k; 2 * k + 1]) ks
+
+  let map2 f d1 d2 = {n = d1.n; m = Array.map2 f d1.m d2.m}
+
+  let leq d1 d2 = Array.for_all2 (<=) d1.m d2.m
+  let join = map2 Stdlib.Float.max
+  let widen = map2 (fun a b -> if b <= a then a else infinity)
+  let narrow = map2 (fun a b -> if a = infinity then b else a)
+
+  (** Returns [None] if the meet is empty. *)
+  let meet d1 d2 =
+    let d = map2 Stdlib.Float.min d1 d2 in
+    if close d then Some d else None
+
+  let forget d k =
+    let d = copy d in
+    let s = 2 * d.n in
+    for v = 2 * k to 2 * k + 1 do
+      for j = 0 to s - 1 do
+        d.m.(v * s + j) <- infinity;
+        d.m.(j * s + v) <- infinity
+      done;
+      d.m.(v * s + v) <- 0.
+    done;
+    d
+
+  (** [x_k := x_k + c] *)
+  let shift d k c =
+    let c = of_z c in
+    let s = 2 * d.n in
+    let delta v = if v = 2 * k then c else if v = 2 * k + 1 then -. c else 0. in
+    let m = Array.copy d.m in
+    for i = 0 to s - 1 do
+      for j = 0 to s - 1 do
+        let dij = delta j -. delta i in
+        if dij <> 0. then
+          m.(i * s + j) <- add m.(i * s + j) dij
+      done
+    done;
+    {d with m}
+
+  (** [x_k := -x_k] *)
+  let negate d k =
+    let s = 2 * d.n in
+    let swap v = if v / 2 = k then bar v else v in
+    {d with m = Array.init (s * s) (fun ij -> d.m.(swap (ij / s) * s + swap (ij mod s)))}
+
+  (** Upper bound of [s * x_k]. *)
+  let upper_unary d k s =
+    Option.map (fun b -> Z.fdiv b (Z.of_int 2)) (to_z (get d (index k (-s)) (index k s)))
+
+  (** Upper bound of [s1 * x_k1 + s2 * x_k2]. *)
+  let upper_binary d k1 s1 k2 s2 =
+    to_z (get d (index k2 (-s2)) (index k1 s1))
+
+  (** Upper bound of the linear sum of [(coefficient, variable)] terms. *)
+  let upper d terms =
+    let interval () =
+      List.fold_left (fun acc (c, k) ->
+          let s = Z.sign c in
+          GobOption.map2 (fun acc b -> Z.(acc + abs c * b)) acc (upper_unary d k s)
+        ) (Some Z.zero) terms
+    in
+    match terms with
+    | [(c1, k1); (c2, k2)] when Z.equal (Z.abs c1) Z.one && Z.equal (Z.abs c2) Z.one ->
+      begin match upper_binary d k1 (Z.sign c1) k2 (Z.sign c2), interval () with
+        | Some b1, Some b2 -> Some (Z.min b1 b2) (* not closed after widening *)
+        | b1, None -> b1
+        | None, b2 -> b2
+      end
+    | _ -> interval ()
+
+  let lower d terms =
+    Option.map Z.neg (upper d (List.map (fun (c, k) -> (Z.neg c, k)) terms))
+
+  (** Meet with [sum terms <= c]. Returns [None] if empty. *)
+  let meet_le d terms c =
+    match terms with
+    | [] ->
+      if Z.leq Z.zero c then Some d else None
+    | [(a, k)] ->
+      let d = copy d in
+      add_unary d k (Z.sign a) (Z.fdiv c (Z.abs a));
+      if close_with (pivots [k]) d then Some d else None
+    | [(a1, k1); (a2, k2)] when Z.equal (Z.abs a1) Z.one && Z.equal (Z.abs a2) Z.one ->
+      let d = copy d in
+      add_binary d k1 (Z.sign a1) k2 (Z.sign a2) c;
+      if close_with (pivots [k1; k2]) d then Some d else None
+    | _ ->
+      (* non-octagonal: bound each variable by the lower bounds of the others *)
+      begin match lower d terms with
+        | Some l when Z.gt l c -> None
+        | _ ->
+          let d' = copy d in
+          List.iteri (fun i (a, k) ->
+              let others = List.filteri (fun j _ -> i <> j) terms in
+              match lower d others with
+              | Some l -> add_unary d' k (Z.sign a) (Z.fdiv Z.(c - l) (Z.abs a))
+              | None -> ()
+            ) terms;
+          if close_with (pivots (List.map snd terms)) d' then Some d' else None
+      end
+
+  (** add variables to the DBM at apron's [add_dimensions] positions, unconstrained *)
+  let dim_add (ch: Apron.Dim.change) d =
+    if Array.length ch.dim = 0 then
+      d
+    else (
+      let map = Array.make d.n 0 in
+      let added = ref 0 in
+      for k = 0 to d.n - 1 do
+        while !added < Array.length ch.dim && ch.dim.(!added) <= k do
+          incr added
+        done;
+        map.(k) <- k + !added
+      done;
+      let d' = top (d.n + Array.length ch.dim) in
+      let s = 2 * d.n in
+      let s' = 2 * d'.n in
+      for i = 0 to s - 1 do
+        let i' = 2 * map.(i / 2) + i mod 2 in
+        for j = 0 to s - 1 do
+          let j' = 2 * map.(j / 2) + j mod 2 in
+          d'.m.(i' * s' + j') <- d.m.(i * s + j)
+        done
+      done;
+      d'
+    )
+
+  let dim_add ch d = VectorMatrix.timing_wrap "dim add" (dim_add ch) d
+
+  (** project out variables; [ch] is in [add_dimensions] format relative to the smaller environment, like for {!LinearTwoVarEqualityDomain} *)
+  let dim_remove (ch: Apron.Dim.change) d ~del =
+    if Array.length ch.dim = 0 || is_empty d then
+      d
+    else (
+      let removed = Array.mapi (+) ch.dim in
+      let map = Array.make d.n (-1) in
+      let r = ref 0 in
+      for k = 0 to d.n - 1 do
+        if !r < Array.length removed && removed.(!r) = k then
+          incr r
+        else
+          map.(k) <- k - !r
+      done;
+      let d' = top (d.n - Array.length removed) in
+      let s = 2 * d.n in
+      let s' = 2 * d'.n in
+      for i = 0 to s - 1 do
+        if map.(i / 2) >= 0 then (
+          let i' = 2 * map.(i / 2) + i mod 2 in
+          for j = 0 to s - 1 do
+            if map.(j / 2) >= 0 then (
+              let j' = 2 * map.(j / 2) + j mod 2 in
+              d'.m.(i' * s' + j') <- d.m.(i * s + j)
+            )
+          done
+        )
+      done;
+      d'
+    )
+
+  let dim_remove ch d ~del = VectorMatrix.timing_wrap "dim remove" (fun d -> dim_remove ch d ~del) d
+
+  (** Finite constraints as [(i, j, c)] for [v_j - v_i <= c], one of each coherent pair. *)
+  let constraints d =
+    let s = 2 * d.n in
+    let r = ref [] in
+    for i = s - 1 downto 0 do
+      for j = s - 1 downto 0 do
+        let c = d.m.(i * s + j) in
+        if i <> j && c < infinity && (bar j, bar i) >= (i, j) then
+          r := (i, j, c) :: !r
+      done
+    done;
+    !r
+end
+
+(** [VarManagement] defines the type t of the octagon domain (a record that contains an optional DBM and an apron environment) and provides the functions needed for handling variables (which are defined by [RelationDomain.D2]) such as [add_vars], [remove_vars].
+    Furthermore, it provides the function [linear_of_texpr] that converts an apron expression into a list of integer-coefficient terms and a constant *)
+module VarManagement =
+struct
+  include SharedFunctions.VarManagementOps (Dbm)
+
+  let size t = BatOption.map_default (fun (d: Dbm.t) -> d.n) 0 t.d
+
+  (** Converts a Texpr to a list of (coefficient, variable index) terms with non-zero coefficients and a constant, unless non-linear. *)
+  let linear_of_texpr env texp =
+    let open Apron.Texpr1 in
+    let module IntMap = BatMap.Int in
+    let exception NotLinearExpr in
+    let scale a (terms, c) = (IntMap.map (Z.mul a) terms, Z.mul a c) in
+    let add (terms1, c1) (terms2, c2) = (IntMap.union (fun _ a b -> Some (Z.add a b)) terms1 terms2, Z.add c1 c2) in
+    let rec convert_texpr = function
+      | Cst (Interval _) -> raise NotLinearExpr
+      | Cst (Scalar x) ->
+        begin match SharedFunctions.int_of_scalar ?round:None x with
+          | Some x -> (IntMap.empty, x)
+          | None -> raise NotLinearExpr
+        end
+      | Var x -> (IntMap.singleton (Environment.dim_of_var env x) Z.one, Z.zero)
+      | Unop (Neg, e, _, _) -> scale Z.minus_one (convert_texpr e)
+      | Unop (Cast, e, _, _) -> convert_texpr e (* Ignore since casts in apron are used for floating point nums and rounding in contrast to CIL casts *)
+      | Unop (Sqrt, _, _, _) -> raise NotLinearExpr
+      | Binop (Add, e1, e2, _, _) -> add (convert_texpr e1) (convert_texpr e2)
+      | Binop (Sub, e1, e2, _, _) -> add (convert_texpr e1) (scale Z.minus_one (convert_texpr e2))
+      | Binop (Mul, e1, e2, _, _) ->
+        begin match convert_texpr e1, convert_texpr e2 with
+          | (terms1, c1), l when IntMap.is_empty terms1 -> scale c1 l
+          | l, (terms2, c2) when IntMap.is_empty terms2 -> scale c2 l
+          | _ -> raise NotLinearExpr
+        end
+      | Binop _ -> raise NotLinearExpr
+    in
+    match convert_texpr texp with
+    | (terms, c) ->
+      let terms = IntMap.fold (fun k a acc -> if Z.equal a Z.zero then acc else (a, k) :: acc) terms [] in
+      Some (List.rev terms, c)
+    | exception NotLinearExpr -> None
+
+  let linear_of_texpr env texp = VectorMatrix.timing_wrap "linear_of_texpr" (linear_of_texpr env) texp
+end
+
+module ExpressionBounds: (SharedFunctions.ConvBounds with type t = VarManagement.t) =
+struct
+  include VarManagement
+
+  let bound_texpr t texpr =
+    match t.d with
+    | None -> None, None
+    | Some d ->
+      match linear_of_texpr t.env (Texpr1.to_expr texpr) with
+      | Some (terms, c) ->
+        let min = Option.map (Z.add c) (Dbm.lower d terms) in
+        let max = Option.map (Z.add c) (Dbm.upper d terms) in
+        if M.tracing then M.tracel "bounds" "min: %s max: %s" (BatOption.map_default Z.to_string "-∞" min) (BatOption.map_default Z.to_string "∞" max);
+        min, max
+      | None -> None, None
+
+  let bound_texpr d texpr1 = VectorMatrix.timing_wrap "bounds calculation" (bound_texpr d) texpr1
+end
+
+module D =
+struct
+  include Printable.Std
+  include VarManagement
+
+  module Bounds = ExpressionBounds
+  module V = RelationDomain.V
+  module Arg = struct
+    let allow_global = true
+  end
+  module Convert = SharedFunctions.Convert (V) (Bounds) (Arg) (SharedFunctions.Tracked)
+
+  type var = V.t
+
+  let name () = "octagon"
+
+  (** t.d is some empty DBM and env is empty *)
+  let is_bot t = equal t (bot ())
+
+  let top_of env = {d = Some (Dbm.top (Environment.size env)); env = env}
+
+  let top () = {d = Some (Dbm.empty ()); env = empty_env}
+
+  let is_top t = GobOption.exists Dbm.is_top t.d
+
+  let show_var env k = Var.to_string (Environment.var_of_dim env k)
+
+  let show_constraint env (i, j, c) =
+    let term v = (if v mod 2 = 0 then "" else "-") ^ show_var env (v / 2) in
+    if i = Dbm.bar j then
+      Printf.sprintf "%s ≤ %s" (term j) (Z.to_string (Z.fdiv (Z.of_float c) (Z.of_int 2)))
+    else
+      Printf.sprintf "%s - %s ≤ %s" (term j) (term i) (Z.to_string (Z.of_float c))
+
+  (** prints the current octagonal constraints with resolved variable names *)
+  let show t =
+    match t.d with
+    | None -> "⊥\n"
+    | Some d when Dbm.is_top d -> "⊤\n"
+    | Some d -> "{" ^ String.concat " ∧ " (List.map (show_constraint t.env) (Dbm.constraints d)) ^ "}"
+
+  let pretty () (x:t) = text (show x)
+  let printXml f x = BatPrintf.fprintf f "<value>\n<map>\n<key>\nconstraints\n</key>\n<value>\n%s</value>\n<key>\nenv\n</key>\n<value>\n%a</value>\n</map>\n</value>\n" (XmlUtil.escape (show x)) Environment.printXml x.env
+  let to_yojson t = `String (show t)
+  let eval_interval ask = Bounds.bound_texpr
+
+  let meet t1 t2 =
+    let sup_env = Environment.lce t1.env t2.env in
+    let t1 = change_d t1 sup_env ~add:true ~del:false in
+    let t2 = change_d t2 sup_env ~add:true ~del:false in
+    match t1.d, t2.d with
+    | Some d1, Some d2 -> {d = Dbm.meet d1 d2; env = sup_env}
+    | _ -> {d = None; env = sup_env}
+
+  let meet t1 t2 =
+    let res = meet t1 t2 in
+    if M.tracing then M.tracel "meet" "meet a: %s\n U  \n b: %s \n -> %s" (show t1) (show t2) (show res) ;
+    res
+
+  let meet t1 t2 = VectorMatrix.timing_wrap "meet" (meet t1) t2
+
+  let leq t1 t2 =
+    let env_comp = Environment.cmp t1.env t2.env in (* Apron's Environment.cmp has defined return values. *)
+    if env_comp = -2 || env_comp > 0 then false else
+    if is_bot_env t1 || is_top t2 then true
+    else if is_bot_env t2 || is_top t1 then false else
+      let d1, d2 = Option.get t1.d, Option.get t2.d in
+      let d1' = if env_comp = 0 then d1 else Dbm.dim_add (Environment.dimchange t1.env t2.env) d1 in
+      Dbm.leq d1' d2
+
+  let leq a b = VectorMatrix.timing_wrap "leq" (leq a) b
+
+  let leq t1 t2 =
+    let res = leq t1 t2 in
+    if M.tracing then M.tracel "leq" "leq a: %s b: %s -> %b" (show t1) (show t2) res ;
+    res
+
+  (** Pointwise operation on DBMs over the least common environment. *)
+  let pointwise op a b =
+    match a.d, b.d with
+    | None, _ -> b
+    | _, None -> a
+    | Some x, Some y when Environment.cmp a.env b.env <> 0 ->
+      let sup_env = Environment.lce a.env b.env in
+      let x = Dbm.dim_add (Environment.dimchange a.env sup_env) x in
+      let y = Dbm.dim_add (Environment.dimchange b.env sup_env) y in
+      {d = Some (op x y); env = sup_env}
+    | Some x, Some y when Dbm.equal x y -> {d = Some x; env = a.env}
+    | Some x, Some y -> {d = Some (op x y); env = a.env}
+
+  let join a b = VectorMatrix.timing_wrap "join" (pointwise Dbm.join a) b
+
+  let join a b =
+    let res = join a b in
+    if M.tracing then M.tracel "join" "join a: %s b: %s -> %s" (show a) (show b) (show res) ;
+    res
+
+  let widen a b = pointwise Dbm.widen a b
+
+  let widen a b =
+    let res = widen a b in
+    if M.tracing then M.tracel "widen" "widen a: %s b: %s -> %s" (show a) (show b) (show res) ;
+    res
+
+  let narrow a b =
+    match a.d, b.d with
+    | Some _, Some _ when Environment.equal a.env b.env -> pointwise Dbm.narrow a b
+    | _ -> meet a b
+
+  let narrow a b =
+    let res = narrow a b in
+    if M.tracing then M.tracel "narrow" "narrow a: %s b: %s -> %s" (show a) (show b) (show res) ;
+    res
+
+  let pretty_diff () (x, y) =
+    dprintf "%s: %a not leq %a" (name ()) pretty x pretty y
+
+  let forget_vars t vars =
+    match t.d with
+    | Some d when not (List.is_empty vars) ->
+      let d = List.fold_left (fun d var -> Dbm.forget d (Environment.dim_of_var t.env var)) d vars in
+      {d = Some d; env = t.env}
+    | _ -> t
+
+  let forget_vars t vars =
+    let res = forget_vars t vars in
+    if M.tracing then M.tracel "ops" "forget_vars %s -> %s" (show t) (show res);
+    res
+
+  let forget_vars t vars = VectorMatrix.timing_wrap "forget_vars" (forget_vars t) vars
+
+  let assign_texpr (t: VarManagement.t) var texp =
+    match t.d with
+    | None -> t
+    | Some d ->
+      let k = Environment.dim_of_var t.env var in (* this is the variable we are assigning to *)
+      let is_unit a = Z.equal (Z.abs a) Z.one in
+      let d' = match linear_of_texpr t.env texp with
+        | None ->
+          (* Statement "assigned_var = ?" (non-linear assignment) *)
+          Some (Dbm.forget d k)
+        | Some ([(a, i)], c) when i = k && Z.equal a Z.one ->
+          (* Statement "assigned_var = assigned_var + c" *)
+          Some (Dbm.shift d k c)
+        | Some ([(a, i)], c) when i = k && Z.equal a Z.minus_one ->
+          (* Statement "assigned_var = -assigned_var + c" *)
+          Some (Dbm.shift (Dbm.negate d k) k c)
+        | Some ([(a, i)], c) when is_unit a && i <> k ->
+          (* Statement "assigned_var = ±var + c", i.e. octagonal x_k - a*x_i = c *)
+          let d = Dbm.forget d k in
+          let s = Z.sign a in
+          Dbm.add_binary d k 1 i (-s) c;
+          Dbm.add_binary d k (-1) i s (Z.neg c);
+          if Dbm.close_with (Dbm.pivots [k; i]) d then Some d else None
+        | Some (terms, c) ->
+          (* Statement "assigned_var = c" or non-octagonal linear assignment: interval of the right-hand side *)
+          let lower = Option.map (Z.add c) (Dbm.lower d terms) in
+          let upper = Option.map (Z.add c) (Dbm.upper d terms) in
+          let d = Dbm.forget d k in
+          Option.may (Dbm.add_unary d k 1) upper;
+          Option.may (fun l -> Dbm.add_unary d k (-1) (Z.neg l)) lower;
+          if Dbm.close_with (Dbm.pivots [k]) d then Some d else None
+      in
+      {d = d'; env = t.env}
+
+  let assign_texpr t var texp = VectorMatrix.timing_wrap "assign_texpr" (assign_texpr t var) texp
+
+  let assign_exp ask (t: VarManagement.t) var exp (no_ov: bool Lazy.t) =
+    let t = if not @@ Environment.mem_var t.env var then add_vars t [var] else t in
+    match Convert.texpr1_expr_of_cil_exp ask t t.env exp no_ov with
+    | texp -> assign_texpr t var texp
+    | exception Convert.Unsupported_CilExp _ -> forget_vars t [var]
+
+  let assign_exp ask t var exp no_ov =
+    let res = assign_exp ask t var exp no_ov in
+    if M.tracing then M.tracel "ops" "assign_exp t:\n %s \n var: %a \n exp: %a\n no_ov: %b -> \n %s"
+        (show t) Var.pretty var d_exp exp (Lazy.force no_ov) (show res);
+    res
+
+  let assign_var (t: VarManagement.t) v v' =
+    let t = add_vars t [v; v'] in
+    assign_texpr t v (Var v')
+
+  let assign_var t v v' =
+    let res = assign_var t v v' in
+    if M.tracing then M.tracel "ops" "assign_var t:\n %s \n v: %a \n v': %a\n -> %s" (show t) Var.pretty v Var.pretty v' (show res);
+    res
+
+  (** Parallel assignment of variables.
+      First apply the assignments to temporary variables x' and y' to keep the old dependencies of x and y
+      and in a second round assign x' to x and y' to y
+  *)
+  let assign_var_parallel t vv's =
+    let assigned_vars = List.map fst vv's in
+    let t = add_vars t assigned_vars in
+    let primed_vars = List.init (List.length assigned_vars) (fun i -> Var.of_string (Int.to_string i  ^"'")) in (* TODO: we use primed vars in analysis, conflict? *)
+    let t_primed = add_vars t primed_vars in
+    let multi_t = List.fold_left2 (fun t' v_prime (_,v') -> assign_var t' v_prime v') t_primed primed_vars vv's in
+    match multi_t.d with
+    | Some _ when not @@ is_top multi_t ->
+      let switched = List.fold_left2 (fun multi_t assigned_var primed_var -> assign_var multi_t assigned_var primed_var) multi_t assigned_vars primed_vars in
+      drop_vars switched primed_vars ~del:true
+    | _ -> t
+
+  let assign_var_parallel t vv's = VectorMatrix.timing_wrap "var_parallel" (assign_var_parallel t) vv's
+
+  let assign_var_parallel_with t vv's =
+    let t' = assign_var_parallel t vv's in
+    t.d <- t'.d;
+    t.env <- t'.env
+
+  let assign_var_parallel' t vs1 vs2 =
+    let vv's = List.combine vs1 vs2 in
+    assign_var_parallel t vv's
+
+  let substitute_exp ask t var exp no_ov =
+    let t = if not @@ Environment.mem_var t.env var then add_vars t [var] else t in
+    let res = assign_exp ask t var exp no_ov in
+    forget_vars res [var]
+
+  let substitute_exp ask t var exp no_ov =
+    let res = substitute_exp ask t var exp no_ov in
+    if M.tracing then M.tracel "ops" "Substitute_expr t: \n %s \n var: %a \n exp: %a \n -> \n %s" (show t) Var.pretty var d_exp exp (show res);
+    res
+
+  let substitute_exp ask t var exp no_ov = VectorMatrix.timing_wrap "substitution" (substitute_exp ask t var exp) no_ov
+
+  (** Meet with a tree constraint [texpr op 0].
+      Constraints on at most two variables with unit coefficients are octagonal,
+      other linear constraints only bound each of their variables. *)
+  let meet_tcons ask t tcons original_expr no_ov =
+    match t.d with
+    | None -> t
+    | Some d ->
+      match linear_of_texpr t.env (Texpr1.to_expr @@ Tcons1.get_texpr1 tcons) with
+      | None -> t
+      | Some (terms, c) ->
+        let neg_terms = List.map (fun (a, k) -> (Z.neg a, k)) terms in
+        let d' = match Tcons1.get_typ tcons with
+          | SUPEQ -> Dbm.meet_le d neg_terms c (* terms + c >= 0 *)
+          | SUP -> Dbm.meet_le d neg_terms (Z.pred c) (* integers: terms + c - 1 >= 0 *)
+          | EQ -> Option.bind (Dbm.meet_le d neg_terms c) (fun d -> Dbm.meet_le d terms (Z.neg c))
+          | DISEQ ->
+            begin match Dbm.lower d terms, Dbm.upper d terms with
+              | Some l, Some u when Z.equal l (Z.neg c) && Z.equal u (Z.neg c) -> None
+              | _ -> Some d
+            end
+          | EQMOD _ -> Some d
+        in
+        {d = d'; env = t.env}
+
+  let meet_tcons ask t tcons original_expr no_ov =
+    if M.tracing then M.tracel "meet_tcons" "meet_tcons with expr: %a no_ov:%b" d_exp original_expr (Lazy.force no_ov);
+    meet_tcons ask t tcons original_expr no_ov
+
+  let meet_tcons t tcons expr = VectorMatrix.timing_wrap "meet_tcons" (meet_tcons t tcons) expr
+
+  let unify a b =
+    meet a b
+
+  let unify a b =
+    let res = unify a b in
+    if M.tracing then M.tracel "ops" "unify: %s\n    U\n %s -> %s" (show a) (show b) (show res);
+    res
+
+  (** Assert a constraint expression.
+      Logical connectives and disequalities are handled by meets and joins like in {!ApronDomain}. *)
+  let rec assert_constraint ask d e negate (no_ov: bool Lazy.t) =
+    match e with
+    | BinOp (Ne, lhs, rhs, intType) when not negate ->
+      let assert_gt = assert_constraint ask d (BinOp (Gt, lhs, rhs, intType)) negate no_ov in
+      let assert_lt = assert_constraint ask d (BinOp (Lt, lhs, rhs, intType)) negate no_ov in
+      join assert_gt assert_lt
+    | BinOp (Eq, lhs, rhs, intType) when negate ->
+      let assert_gt = assert_constraint ask d (BinOp (Gt, lhs, rhs, intType)) (not negate) no_ov in
+      let assert_lt = assert_constraint ask d (BinOp (Lt, lhs, rhs, intType)) (not negate) no_ov in
+      join assert_gt assert_lt
+    | BinOp (LAnd, lhs, rhs, intType) when not negate ->
+      let assert_l = assert_constraint ask d lhs negate no_ov in
+      let assert_r = assert_constraint ask d rhs negate no_ov in
+      meet assert_l assert_r
+    | BinOp (LAnd, lhs, rhs, intType) when negate ->
+      let assert_l = assert_constraint ask d lhs negate no_ov in
+      let assert_r = assert_constraint ask d rhs negate no_ov in
+      join assert_l assert_r (* de Morgan *)
+    | BinOp (LOr, lhs, rhs, intType) when not negate ->
+      let assert_l = assert_constraint ask d lhs negate no_ov in
+      let assert_r = assert_constraint ask d rhs negate no_ov in
+      join assert_l assert_r
+    | BinOp (LOr, lhs, rhs, intType) when negate ->
+      let assert_l = assert_constraint ask d lhs negate no_ov in
+      let assert_r = assert_constraint ask d rhs negate no_ov in
+      meet assert_l assert_r (* de Morgan *)
+    | UnOp (LNot,e,_) -> assert_constraint ask d e (not negate) no_ov
+    | _ ->
+      match Convert.tcons1_of_cil_exp ask d d.env e negate no_ov with
+      | tcons1 -> meet_tcons ask d tcons1 e no_ov
+      | exception Convert.Unsupported_CilExp _ -> d
+
+  let assert_constraint ask d e negate no_ov = VectorMatrix.timing_wrap "assert_constraint" (assert_constraint ask d e negate) no_ov
+
+  let relift t = t
+
+  (** representation as C expression
+
+      This function returns all the octagonal constraints that are saved in our datastructure t.
+
+      Lincons -> linear constraint *)
+  let invariant t =
+    match t.d with
+    | None -> []
+    | Some d ->
+      List.map (fun (i, j, c) ->
+          (* v_j - v_i <= c  as  -v_j + v_i + c >= 0 *)
+          let coeff v sign = (Coeff.s_of_int (if v mod 2 = 0 then sign else -sign), Environment.var_of_dim t.env (v / 2)) in
+          let coeffs, cst =
+            if i = Dbm.bar j then
+              [coeff j (-1)], Z.fdiv (Z.of_float c) (Z.of_int 2)
+            else
+              [coeff j (-1); coeff i 1], Z.of_float c
+          in
+          let lincons = Lincons1.make (Linexpr1.make t.env) Lincons1.SUPEQ in
+          Lincons1.set_list lincons coeffs (Some (Coeff.s_of_z cst));
+          lincons
+        ) (Dbm.constraints d)
+
+  let cil_exp_of_lincons1 = Convert.cil_exp_of_lincons1
+
+  let env t = t.env
+
+  type marshal = t
+  (* marshal is not compatible with apron, therefore we don't have to implement it *)
+  let marshal t = t
+
+  let unmarshal t = t
+
+end
+
+module D2: RelationDomain.RD with type var = Var.t =
+struct
+  module D = D
+  module ConvArg = struct
+    let allow_global = false
+  end
+  include SharedFunctions.AssertionModule (D.V) (D) (ConvArg)
+  include D
+end
@@ -0,0 +1,5 @@
+(* This domain is empty on purpose. It serves only as an alternative dependency
+   in cases where the actual domain can't be used because of a missing library.
+   It was added because we don't want to fully depend on Apron. *)
+
+let reset_lazy () = ()
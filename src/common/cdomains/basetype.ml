@@ -121,6 +121,19 @@ struct
     | Lval (Mem e',_) -> (get_vars e')
 end
 
+(** Interned expressions for expression-keyed domains.
+    Structurally equal expressions get the same unique id, such that [equal], [compare] and [hash] don't traverse the expressions.
+    [relift] interns again after loading, which is therefore done regardless of the hashconsing options, because tags are only unique within a process. *)
+(* HAS SIDE-EFFECTS ---- PLEASE INSTANCIATE ONLY ONCE!!! *)
+module InternedExp =
+struct
+  include Printable.HConsedOpt (CilType.Exp) (struct let enabled () = true end)
+  let name () = "interned expressions"
+
+  let of_exp = lift
+  let to_exp = unlift
+end
+
 module CilStmt: Printable.S with type t = stmt =
 struct
   include CilType.Stmt
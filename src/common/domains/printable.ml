@@ -162,6 +162,70 @@ struct
   let arbitrary () = QCheck.map ~rev:unlift lift (Base.arbitrary ())
 end
 
+(** Like {!HConsed}, but hashconsing can be disabled at runtime by [Arg.enabled]
+    and the table is weak, such that the GC can reclaim values which are no longer used.
+    Values created while disabled have tag [-1] and use [Base] operations instead.
+    [Arg.enabled] must not change during an analysis, otherwise tag-based [compare] is inconsistent. *)
+(* HAS SIDE-EFFECTS ---- PLEASE INSTANCIATE ONLY ONCE!!! *)
+module HConsedOpt (Base: S) (Arg: sig val enabled: unit -> bool end) =
+struct
+  include Std (* for default invariant, ... *)
+
+  type t = {
+    obj: Base.t;
+    tag: int;
+    hcode: int;
+  }
+
+  module W = Weak.Make (
+    struct
+      type nonrec t = t
+      let equal x y = Base.equal x.obj y.obj
+      let hash x = x.hcode
+    end
+    )
+  let wtable = W.create 1024
+  let next_tag = ref 0
+
+  let unlift x = x.obj
+  let lift obj =
+    if Arg.enabled () then (
+      let x = {obj; tag = !next_tag; hcode = Base.hash obj} in
+      let x' = W.merge wtable x in
+      if x' == x then incr next_tag;
+      x'
+    )
+    else
+      {obj; tag = -1; hcode = 0}
+  let lift_f f x = f x.obj
+
+  (** Lift result of operation on [x], avoiding rehashing if it didn't change. *)
+  let lift_if_changed x obj = if obj == x.obj then x else lift obj
+
+  let is_tagged x = x.tag >= 0
+
+  let show = lift_f Base.show
+  let pretty () = lift_f (Base.pretty ())
+  let printXml f x = Base.printXml f x.obj
+  let to_yojson = lift_f Base.to_yojson
+  let name () = "HConsedOpt " ^ Base.name ()
+
+  let relift x = lift (Base.relift x.obj)
+  let tag x = x.tag
+  let equal x y =
+    if is_tagged x && is_tagged y then
+      x.tag = y.tag
+    else
+      x == y || Base.equal x.obj y.obj
+  let hash x = if is_tagged x then x.hcode else Base.hash x.obj
+  let compare x y =
+    if is_tagged x && is_tagged y then
+      Int.compare x.tag y.tag
+    else
+      Base.compare x.obj y.obj
+  let arbitrary () = QCheck.map ~rev:unlift lift (Base.arbitrary ())
+end
+
 module HashCached (M: S) =
 struct
   module LazyHash = LazyEval.Make (struct type t = M.t type result = int let eval = M.hash end)
@@ -676,10 +676,76 @@ let dead_code_cfg (module FileCfg: MyCFG.FileCfg) live =
     )
 
 
-let getGlobalInits (file: file) : edges  =
+(** Whether a type is an array or struct of only integer, enum and floating-point scalars, whose writes no analysis but base observes.
+    Characters are excluded, because base tracks assignments of characters to arrays as strings. *)
+let is_bulk_global_type typ =
+  let rec numeric typ =
+    match unrollType typ with
+    | TInt ((IChar | ISChar | IUChar), _) -> false
+    | TInt _ | TEnum _ | TFloat _ -> true
+    | TArray (t, _, _) -> numeric t
+    | TComp ({cstruct = true; cfields; _}, _) -> List.for_all (fun f -> numeric f.ftype) cfields
+    | _ -> false (* pointers, function pointers, unions, ... *)
+  in
+  match unrollType typ with
+  | TArray _ | TComp _ -> numeric typ
+  | _ -> false
+
+(** Whether a global of type [typ] with initializer [init] can be initialized in bulk instead of assigning each element:
+    a {!is_bulk_global_type} without initializer or with a compound initializer of only integer and floating-point constants. *)
+let is_bulk_global_init typ (init: init option) =
+  let rec constant = function
+    | SingleInit e ->
+      begin match stripCasts e, constFold true e with
+        | Const (CChr _), _ -> false
+        | _, Const (CInt _ | CReal _ | CEnum _) -> true
+        | _, _ -> false
+      end
+    | CompoundInit (_, inits) -> List.for_all (fun (_, init) -> constant init) inits
+  in
+  is_bulk_global_type typ && (
+    match init with
+    | None -> true
+    | Some (CompoundInit _ as init) -> constant init
+    | Some (SingleInit _) -> false
+  )
+
+(** Whether all arrays in global [v] use the trivial array domain, which is the same as in {!ArrayDomain.get_domain}.
+    Bulk initialization joins the initializers of all elements of an array,
+    so other array domains would lose their per-element precision. *)
+let has_trivial_array_domains (v: varinfo) =
+  let annotated attrs =
+    if get_bool "annotation.goblint_array_domain" then
+      List.find_map (function
+          | Attr ("goblint_array_domain", ps) -> List.find_map (function AStr x -> Some x | _ -> None) ps
+          | _ -> None
+        ) attrs
+    else
+      None
+  in
+  let domain var_attrs typ_attrs =
+    match annotated var_attrs, annotated typ_attrs with
+    | Some x, _
+    | None, Some x -> x
+    | None, None -> get_string "ana.base.arrays.domain"
+  in
+  (* attributes as in ValueDomain.bot_value *)
+  let rec trivial var_attrs typ =
+    match unrollType typ with
+    | TArray (t, _, _) -> domain var_attrs (typeAttrs t) = "trivial" && trivial [] t
+    | TComp ({cfields; _}, _) -> List.for_all (fun f -> trivial f.fattr f.ftype) cfields
+    | _ -> true
+  in
+  trivial v.vattr v.vtype
+
+(** Assign edges for global initializers.
+    With [exp.bulk_global_inits], globals satisfying {!is_bulk_global_init} and {!has_trivial_array_domains} are returned separately instead. *)
+let getGlobalInits (file: file) : edges * (location * varinfo * init option) list =
   (* runtime with fast_global_inits: List: 36.25s, Hashtbl: 0.56s *)
   let inits = Hashtbl.create 13 in
+  let bulk_inits = ref [] in
   let fast_global_inits = get_bool "exp.fast_global_inits" in
+  let bulk_global_inits = get_bool "exp.bulk_global_inits" in
   let rec doInit lval loc init is_zero =
     let initoffs offs init typ lval =
       doInit (addOffsetLval offs lval) loc init is_zero;
@@ -709,6 +775,8 @@ let getGlobalInits (file: file) : edges  =
   in
   let f glob =
     match glob with
+    | GVar (v, {init}, loc) when bulk_global_inits && is_bulk_global_init v.vtype init && has_trivial_array_domains v ->
+      bulk_inits := (loc, v, init) :: !bulk_inits
     | GVar ({vtype=vtype; _} as v, init, loc) -> begin
         let init, is_zero = match init.init with
           | None -> makeZeroInit vtype, true
@@ -721,7 +789,7 @@ let getGlobalInits (file: file) : edges  =
   iterGlobals file f;
   let initfun = emptyFunction "__goblint_dummy_init" in
   (* order is not important since only compile-time constants can be assigned *)
-  ({line = 0; file="initfun"; byte= 0; column = 0; endLine = -1; endByte = -1; endColumn = -1; synthetic = true}, Entry initfun) :: (BatHashtbl.keys inits |> BatList.of_enum)
+  ({line = 0; file="initfun"; byte= 0; column = 0; endLine = -1; endByte = -1; endColumn = -1; synthetic = true}, Entry initfun) :: (BatHashtbl.keys inits |> BatList.of_enum), !bulk_inits
 
 
 let numGlobals file =
@@ -371,6 +371,69 @@ and typeOffset basetyp =
       blendAttributes baseAttrs fieldType
     | t -> raise (TypeOfError (Field_NonCompound (fi, t)))
 
+(** Physical hashtable of expressions. *)
+module ExpPhysH = Hashtbl.Make (struct
+    type t = exp
+    let equal = (==)
+    (* Offsets are hashed as well, such that the many field and index accesses of one variable don't share a bucket. *)
+    let rec hash_offset = function
+      | NoOffset -> 0
+      | Field (fi, o) -> 31 * hash_offset o + Hashtbl.hash fi.fname
+      | Index (i, o) -> 31 * hash_offset o + hash i
+    and hash = function
+      | Lval (Var v, o) -> 3 * (v.vid + 31 * hash_offset o)
+      | AddrOf (Var v, o) -> 3 * (v.vid + 31 * hash_offset o) + 1
+      | StartOf (Var v, o) -> 3 * (v.vid + 31 * hash_offset o) + 2
+      | e -> Hashtbl.hash e
+  end)
+
+(** Types of expressions in the file by physical identity, if computed by {!compute_exp_types}. *)
+let exp_types: typ ExpPhysH.t option ref = ref None
+let exp_types_stats = TagMemo.register "typeOf"
+
+(** Whether the type of an expression needs offset traversal, i.e. is worth caching. *)
+let is_exp_type_cached = function
+  | Lval (Var _, NoOffset)
+  | AddrOf (Var _, NoOffset) -> false
+  | Lval _
+  | AddrOf _
+  | StartOf _ -> true
+  | _ -> false
+
+class expTypesVisitor (table: typ ExpPhysH.t) = object
+  inherit nopCilVisitor
+  method! vexpr e =
+    if is_exp_type_cached e then (
+      match typeOf e with
+      | t -> ExpPhysH.replace table e t
+      | exception TypeOfError _ -> ()
+    );
+    DoChildren
+end
+
+(** Precompute types of all expressions in the file for {!typeOf}.
+    Must be called after all transformations of the file, because cached types are not invalidated until {!reset_lazy}. *)
+let compute_exp_types (file: file) =
+  let table = ExpPhysH.create 1024 in
+  visitCilFileSameGlobals (new expTypesVisitor table) file;
+  exp_types := Some table
+
+(** {!typeOf} using types precomputed by {!compute_exp_types}.
+    @raise TypeOfError *)
+let typeOf (e: exp) : typ =
+  match !exp_types with
+  | Some table when is_exp_type_cached e ->
+    begin match ExpPhysH.find_opt table e with
+      | Some t ->
+        exp_types_stats.hits <- exp_types_stats.hits + 1;
+        t
+      | None ->
+        exp_types_stats.misses <- exp_types_stats.misses + 1;
+        typeOf e
+    end
+  | _ ->
+    typeOf e
+
 
 let typeBlendAttributes baseAttrs = (* copied from Cilfacade.typeOffset *)
   let (_, _, contageous) = partitionAttributes ~default:AttrName baseAttrs in
@@ -614,6 +677,76 @@ let varinfo_fundecs: fundec VarinfoH.t ResettableLazy.t =
 let find_varinfo_fundec vi = VarinfoH.find (ResettableLazy.force varinfo_fundecs) vi (* vi argument must be explicit, otherwise force happens immediately *)
 
 
+class calleeVisitor callees = object
+  inherit nopCilVisitor
+  method! vinst = function
+    | Call (_, Lval (Var vi, NoOffset), _, _, _) ->
+      callees := vi :: !callees;
+      SkipChildren
+    | _ -> SkipChildren
+end
+
+let callgraph_ranks: int VarinfoH.t ResettableLazy.t =
+  ResettableLazy.from_fun (fun () ->
+      (* only static calls to defined functions *)
+      let calls = VarinfoH.create 111 in
+      iterGlobals !current_file (function
+          | GFun (fd, _) ->
+            let callees = ref [] in
+            ignore (visitCilFunction (new calleeVisitor callees) fd);
+            VarinfoH.replace calls fd.svar (List.filter (VarinfoH.mem (ResettableLazy.force varinfo_fundecs)) !callees)
+          | _ -> ()
+        );
+      (* Tarjan's algorithm completes SCCs in reverse topological order, i.e. callees before callers *)
+      let ranks = VarinfoH.create 111 in
+      let index = VarinfoH.create 111 in
+      let lowlink = VarinfoH.create 111 in
+      let on_stack = VarinfoH.create 111 in
+      let stack = ref [] in
+      let next_index = ref 0 in
+      let next_rank = ref 0 in
+      let rec strongconnect v =
+        VarinfoH.replace index v !next_index;
+        VarinfoH.replace lowlink v !next_index;
+        incr next_index;
+        stack := v :: !stack;
+        VarinfoH.replace on_stack v ();
+        List.iter (fun w ->
+            if not (VarinfoH.mem index w) then (
+              strongconnect w;
+              VarinfoH.replace lowlink v (min (VarinfoH.find lowlink v) (VarinfoH.find lowlink w))
+            )
+            else if VarinfoH.mem on_stack w then
+              VarinfoH.replace lowlink v (min (VarinfoH.find lowlink v) (VarinfoH.find index w))
+          ) (Option.value ~default:[] (VarinfoH.find_opt calls v));
+        if VarinfoH.find lowlink v = VarinfoH.find index v then (
+          let rec pop () =
+            match !stack with
+            | w :: stack' ->
+              stack := stack';
+              VarinfoH.remove on_stack w;
+              VarinfoH.replace ranks w !next_rank;
+              if not (CilType.Varinfo.equal w v) then
+                pop ()
+            | [] -> assert false
+          in
+          pop ();
+          incr next_rank
+        )
+      in
+      VarinfoH.iter (fun v _ ->
+          if not (VarinfoH.mem index v) then
+            strongconnect v
+        ) calls;
+      ranks
+    )
+
+(** Find the rank of the call graph SCC of the function's [varinfo].
+    Callees have lower rank than their callers, functions in the same SCC have equal rank.
+    @raise Not_found *)
+let find_varinfo_callgraph_rank vi = VarinfoH.find (ResettableLazy.force callgraph_ranks) vi (* vi argument must be explicit, otherwise force happens immediately *)
+
+
 module StringH = Hashtbl.Make (Printable.Strings)
 
 let name_fundecs: fundec StringH.t ResettableLazy.t =
@@ -733,9 +866,11 @@ let funs_with_upjumping_gotos: unit LocSet.t FunLocH.t = FunLocH.create 13
 
 let reset_lazy ?(keepupjumpinggotos=false) () =
   StmtH.clear pseudo_return_to_fun;
+  exp_types := None;
   if not keepupjumpinggotos then FunLocH.clear funs_with_upjumping_gotos;
   ResettableLazy.reset stmt_fundecs;
   ResettableLazy.reset varinfo_fundecs;
+  ResettableLazy.reset callgraph_ranks;
   ResettableLazy.reset name_fundecs;
   ResettableLazy.reset varinfo_roles;
   ResettableLazy.reset original_names;
@@ -0,0 +1,137 @@
+(** Pool of forked worker processes for read-only work after solving, e.g. [warn_global].
+
+    Workers inherit the solution by forking and process a share of the items each.
+    Instead of adding messages, they send them back to the parent together with the registered {!state} and their timings.
+    The parent merges the results in the order of the shares, so the outcome doesn't depend on scheduling. *)
+
+(** Mutable state, which workers modify and the parent needs afterwards, e.g. summary counters. *)
+type state = State: {
+    reset: unit -> unit; (** Reset in worker before processing its share. *)
+    get: unit -> 'a; (** Get in worker after processing its share. Must be marshalable. *)
+    merge: 'a -> unit; (** Merge result of worker into parent. *)
+  } -> state
+
+let states: state list ref = ref []
+
+(** Register state, which workers modify.
+    Must be called in the same order in all processes, e.g. during module initialization. *)
+let register ~reset ~get ~merge =
+  states := !states @ [State {reset; get; merge}]
+
+(** Result of a worker. *)
+type result = {
+  messages: Messages.Message.t list; (** Localized, in addition order. *)
+  final_messages: Messages.Message.t list; (** Localized. *)
+  values: Obj.t list; (** Values of {!states} in registration order. *)
+  timings: Goblint_timing.tree list;
+}
+
+let work f share filename =
+  ignore (Timing.Default.take_children ());
+  List.iter (fun (State s) -> s.reset ()) !states;
+  let collected = ref [] in
+  Messages.collected := Some collected;
+  List.iter f share;
+  let result = {
+    messages = List.rev_map Messages.Table.Stream.localize !collected;
+    final_messages = List.of_seq (Seq.map Messages.Table.Stream.localize (Messages.Table.MH.to_seq_keys Messages.final_table));
+    values = List.map (fun (State s) -> Obj.repr (s.get ())) !states;
+    timings = Timing.Default.take_children ();
+  }
+  in
+  let oc = open_out_bin filename in
+  Marshal.to_channel oc result [];
+  close_out oc
+
+let merge result =
+  List.iter (fun m -> Messages.add (Messages.Table.Stream.relift m)) result.messages;
+  List.iter (fun m -> Messages.add_final (Messages.Table.Stream.relift m)) result.final_messages;
+  List.iter2 (fun (State s) v -> s.merge (Obj.obj v)) !states result.values;
+  Timing.Default.add_children result.timings
+
+(** Split [items] into [n] contiguous shares of roughly equal length. *)
+let split n items =
+  let items = Array.of_list items in
+  let len = Array.length items in
+  List.init n (fun i ->
+      let first = i * len / n in
+      let last = (i + 1) * len / n in
+      Array.to_list (Array.sub items first (last - first))
+    )
+  |> List.filter (fun share -> share <> [])
+
+(** Wait for any child process, retrying if interrupted by a signal, e.g. of {!Sampling}. *)
+let rec wait () =
+  match Unix.wait () with
+  | r -> r
+  | exception Unix.Unix_error (Unix.EINTR, _, _) -> wait ()
+
+(** [iter ~jobs f items] applies [f] to all [items] using up to [jobs] worker processes at a time.
+    A share, whose worker fails, is processed by the parent itself. *)
+let iter ~jobs f items =
+  if jobs <= 1 || List.compare_length_with items jobs < 0 then
+    List.iter f items
+  else (
+    flush_all (); (* don't duplicate buffered output in workers *)
+    let shares = Array.of_list (split (4 * jobs) items) in
+    let results = Array.make (Array.length shares) None in
+    let procs = Hashtbl.create jobs in
+    let rec run i =
+      if i < Array.length shares && Hashtbl.length procs < jobs then (
+        let filename = Filename.temp_file "goblint_worker" ".marshalled" in
+        match Unix.fork () with
+        | 0 ->
+          let code = match work f shares.(i) filename with
+            | () -> 0
+            | exception _ -> 1
+          in
+          Unix._exit code (* skip at_exit of parent, e.g. removal of its temporary files *)
+        | pid ->
+          Hashtbl.replace procs pid (i, filename);
+          run (i + 1)
+        | exception e ->
+          Sys.remove filename;
+          raise e
+      )
+      else if Hashtbl.length procs > 0 then (
+        let (pid, status) = wait () in
+        begin match Hashtbl.find_opt procs pid with
+          | Some (j, filename) ->
+            Hashtbl.remove procs pid;
+            Fun.protect ~finally:(fun () -> Sys.remove filename) (fun () ->
+                if status = Unix.WEXITED 0 then (
+                  let ic = open_in_bin filename in
+                  Fun.protect ~finally:(fun () -> close_in ic) (fun () ->
+                      results.(j) <- Some (Marshal.from_channel ic: result)
+                    )
+                )
+              )
+          | None -> () (* unrelated process *)
+        end;
+        run i
+      )
+    in
+    (* if the parent fails, e.g. by timeout, don't leave workers and their files behind *)
+    let cleanup () =
+      Hashtbl.iter (fun pid (_, filename) ->
+          (try Unix.kill pid Sys.sigkill with Unix.Unix_error _ -> ());
+          let rec waitpid () =
+            match Unix.waitpid [] pid with
+            | _ -> ()
+            | exception Unix.Unix_error (Unix.EINTR, _, _) -> waitpid ()
+            | exception Unix.Unix_error _ -> ()
+          in
+          waitpid ();
+          (try Sys.remove filename with Sys_error _ -> ())
+        ) procs;
+      Hashtbl.clear procs
+    in
+    Fun.protect ~finally:cleanup (fun () -> run 0);
+    Array.iteri (fun i result ->
+        match result with
+        | Some result -> merge result
+        | None ->
+          Logs.warn "Worker for %d items failed, processing them sequentially" (List.length shares.(i));
+          List.iter f shares.(i)
+      ) results
+  )
@@ -0,0 +1,83 @@
+(** Breakdown of reachable heap words by named groups of roots (see [dbg.heap-breakdown]).
+
+    Values shared between groups, e.g. hashconsed ones, are counted once:
+    besides the words reachable from a group alone, each group is reported with the words it adds to all groups before it.
+    The order of groups thus determines the attribution of shared values.
+    Values reachable from the baseline, e.g. CIL structures reachable from nodes and varinfos, are excluded from all groups.
+    This costs a traversal of the reachable heap, including the baseline, per group, so it is only meant for diagnosing memory usage.
+    {!report_top} therefore only measures a bounded number of groups. *)
+
+type t = {
+  baseline: Obj.t list;
+  roots: (string, Obj.t list ref) Hashtbl.t;
+  mutable order: string list; (** Names in reverse order of first addition. *)
+}
+
+let enabled () = GobConfig.get_bool "dbg.heap-breakdown.enabled"
+
+let create ?(baseline = []) () = {baseline; roots = Hashtbl.create 113; order = []}
+
+(** Add root to the named group. *)
+let add b name x =
+  match Hashtbl.find_opt b.roots name with
+  | Some xs -> xs := x :: !xs
+  | None ->
+    Hashtbl.replace b.roots name (ref [x]);
+    b.order <- name :: b.order
+
+(** Words reachable from roots, excluding the list holding them. *)
+let words (xs: Obj.t list) =
+  Obj.reachable_words (Obj.repr xs) - 3 * List.length xs (* header and two fields per cons cell *)
+
+(** Words reachable from roots, but not from the baseline. *)
+let words_over b baseline_words xs =
+  words (List.rev_append xs b.baseline) - baseline_words
+
+let mib words =
+  float_of_int (words * (Sys.word_size / 8)) /. 1048576.
+
+(** Report all groups in order of their first addition. *)
+let report title b =
+  let baseline_words = words b.baseline in
+  let acc = ref b.baseline in
+  let total = ref baseline_words in
+  let rows = List.fold_left (fun rows name ->
+      let xs = !(Hashtbl.find b.roots name) in
+      acc := List.rev_append xs !acc;
+      let total' = words !acc in
+      let row = (name, words_over b baseline_words xs, total' - !total) in
+      total := total';
+      row :: rows
+    ) [] (List.rev b.order)
+  in
+  let added = !total - baseline_words in
+  Logs.info "%s: %d words (%.1f MiB) reachable over baseline of %d words (%.1f MiB)" title added (mib added) baseline_words (mib baseline_words);
+  Logs.info "%12s %12s  %s" "own words" "added words" "group";
+  List.iter (fun (name, own, added) ->
+      Logs.info "%12d %12d  %s" own added name
+    ) (List.rev rows)
+
+(** Report [n] groups with most words reachable from them alone over the baseline.
+    Measuring a group traverses the baseline again, so only the [measure] groups with most roots are measured, unless it is 0. *)
+let report_top title ~measure n b =
+  let baseline_words = words b.baseline in
+  let groups = Hashtbl.fold (fun name xs acc -> (name, !xs) :: acc) b.roots [] in
+  let groups =
+    if measure > 0 && List.length groups > measure then
+      groups
+      |> List.map (fun (name, xs) -> (List.length xs, (name, xs)))
+      |> List.sort (fun (l1, _) (l2, _) -> Int.compare l2 l1)
+      |> BatList.take measure
+      |> List.map snd
+    else
+      groups
+  in
+  let rows =
+    List.map (fun (name, xs) -> (name, words_over b baseline_words xs)) groups
+    |> List.sort (fun (_, w1) (_, w2) -> Int.compare w2 w1)
+    |> BatList.take n
+  in
+  Logs.info "%s: top %d of %d measured of %d" title (List.length rows) (List.length groups) (Hashtbl.length b.roots);
+  List.iter (fun (name, own) ->
+      Logs.info "%12d words (%.1f MiB)  %s" own (mib own) name
+    ) rows
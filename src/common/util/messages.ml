@@ -154,27 +154,179 @@ struct
   let messages_table = MH.create 113 (* messages without order for quick mem lookup *)
   let messages_list = ref [] (* messages with reverse order (for cons efficiency) *)
 
-  let mem = MH.mem messages_table
+  (** Streaming of messages (see [warn.stream]).
+      Instead of [messages_table] and [messages_list], only digests of messages are kept in memory for deduplication,
+      and messages are spilled to a temporary file in runs, from which outputs read them back.
+      With [warn.deterministic], each run is sorted when spilled and runs are merged when read. *)
+  module Stream =
+  struct
+    let enabled = ref false
+
+    (** Message with node locations replaced by their current CIL locations, such that it can be marshaled without the CFG. *)
+    let localize (m: Message.t): Message.t =
+      let localize_loc = Option.map (fun loc -> Location.CilLocation (Location.to_cil loc)) in
+      let localize_piece (piece: Piece.t) = {piece with loc = localize_loc piece.loc} in
+      let multipiece: MultiPiece.t = match m.multipiece with
+        | Single piece -> Single (localize_piece piece)
+        | Group group -> Group {group with group_loc = localize_loc group.group_loc; pieces = List.map localize_piece group.pieces}
+      in
+      {m with multipiece}
+
+    let relift (m: Message.t): Message.t =
+      let relift_piece (piece: Piece.t) = {piece with context = Option.map ControlSpecC.relift piece.context} in
+      let multipiece: MultiPiece.t = match m.multipiece with
+        | Single piece -> Single (relift_piece piece)
+        | Group group -> Group {group with pieces = List.map relift_piece group.pieces}
+      in
+      {m with multipiece}
+
+    let index: (Digest.t, unit) Hashtbl.t = Hashtbl.create 113
+
+    (** Number of messages per spilled run (see [warn.stream-run-length]). *)
+    let run_length = ref 10_000
+
+    (** Current run with reverse order, which has not been spilled yet. *)
+    let run: Message.t list ref = ref []
+    let run_size = ref 0
+
+    (** Spilled runs as offset in file and number of messages, with reverse order. *)
+    let runs: (int * int) list ref = ref []
+
+    let spill: (string * out_channel) option ref = ref None
+
+    (* digest of JSON, which contains current CIL locations and context tags, but not nodes and contexts themselves *)
+    let digest m = Digest.string (Yojson.Safe.to_string (Message.to_yojson m))
+
+    let mem m = Hashtbl.mem index (digest m)
+
+    let spill_channel () =
+      match !spill with
+      | Some (_, oc) -> oc
+      | None ->
+        let (filename, oc) = Filename.open_temp_file ~mode:[Open_binary] "goblint_messages" ".marshalled" in
+        at_exit (fun () ->
+            close_out_noerr oc;
+            try Sys.remove filename with Sys_error _ -> ()
+          );
+        spill := Some (filename, oc);
+        oc
+
+    let flush_run () =
+      if !run_size > 0 then (
+        let messages =
+          if get_bool "warn.deterministic" then
+            List.sort Message.compare !run
+          else
+            List.rev !run
+        in
+        let oc = spill_channel () in
+        runs := (pos_out oc, !run_size) :: !runs;
+        List.iter (fun m -> Marshal.to_channel oc m []) messages;
+        run := [];
+        run_size := 0
+      )
+
+    let add m =
+      Hashtbl.replace index (digest m) ();
+      run := localize m :: !run;
+      incr run_size;
+      if !run_size >= !run_length then
+        flush_run ()
+
+    (** Reader of a spilled run, which returns its messages in order and [None] at the end. *)
+    let read_run filename (offset, count) =
+      let ic = open_in_bin filename in
+      seek_in ic offset;
+      let remaining = ref count in
+      fun () ->
+        if !remaining = 0 then (
+          close_in ic;
+          None
+        )
+        else (
+          decr remaining;
+          Some (relift (Marshal.from_channel ic: Message.t))
+        )
+
+    let iter f =
+      flush_run ();
+      match !spill with
+      | None -> ()
+      | Some (filename, oc) ->
+        flush oc;
+        let readers = List.rev_map (read_run filename) !runs in
+        if get_bool "warn.deterministic" then (
+          (* k-way merge of sorted runs *)
+          let module Heads = Set.Make (struct type t = Message.t * int [@@deriving ord] end) in
+          let readers = Array.of_list readers in
+          let next heads i =
+            match readers.(i) () with
+            | Some m -> Heads.add (m, i) heads
+            | None -> heads
+          in
+          let rec merge heads =
+            match Heads.min_elt_opt heads with
+            | Some ((m, i) as head) ->
+              f m;
+              merge (next (Heads.remove head heads) i)
+            | None -> ()
+          in
+          merge (List.fold_left next Heads.empty (List.init (Array.length readers) Fun.id))
+        )
+        else (
+          let rec iter_run read =
+            match read () with
+            | Some m -> f m; iter_run read
+            | None -> ()
+          in
+          List.iter iter_run readers
+        )
+  end
+
+  let mem m =
+    if !Stream.enabled then
+      Stream.mem m
+    else
+      MH.mem messages_table m
 
   let add_hook: (Message.t -> unit) ref = ref (fun _ -> ())
 
   let add m =
-    MH.replace messages_table m ();
-    messages_list := m :: !messages_list;
+    if !Stream.enabled then
+      Stream.add m
+    else (
+      MH.replace messages_table m ();
+      messages_list := m :: !messages_list
+    );
     !add_hook m
 
+  (** Iterate over messages in addition order, or sorted order when streaming deterministically. *)
+  let iter f =
+    if !Stream.enabled then
+      Stream.iter f
+    else
+      List.iter f (List.rev !messages_list)
+
   let to_list () =
-    List.rev !messages_list (* reverse to get in addition order *)
+    if !Stream.enabled then (
+      let messages = ref [] in
+      Stream.iter (fun m -> messages := m :: !messages);
+      List.rev !messages
+    )
+    else
+      List.rev !messages_list (* reverse to get in addition order *)
 
   let to_yojson () =
     [%to_yojson: Message.t list] (to_list ())
 end
 
-
 let formatter = ref Format.std_formatter
 let () = AfterConfig.register (fun () ->
     if !formatter == Format.std_formatter && MessageUtil.colors_on Unix.stdout then
-      GobFormat.pp_set_ansi_color_tags !formatter
+      GobFormat.pp_set_ansi_color_tags !formatter;
+    (* incremental server and Gobview need all messages in memory *)
+    Table.Stream.enabled := get_bool "warn.stream" && not (get_bool "server.enabled") && not (get_bool "gobview");
+    Table.Stream.run_length := get_int "warn.stream-run-length"
   )
 
 let xml_file_name = ref ""
@@ -243,11 +395,22 @@ let print ?(ppf= !formatter) (m: Message.t) =
   Format.fprintf ppf "@[<v 2>%t %t@]\n%!" pp_prefix pp_multipiece
 
 
+(** Messages collected instead of being added, in reverse order, e.g. by a worker of {!ForkPool}. *)
+let collected: Message.t list ref option ref = ref None
+
+(** Called for every message passed to {!add}, also if it is a duplicate, which isn't added again. *)
+let emit_hook: (Message.t -> unit) ref = ref (fun _ -> ())
+
 let add m =
+  !emit_hook m;
   if not (Table.mem m) then (
-    if not (get_bool "warn.deterministic") then
-      print m;
-    Table.add m
+    match !collected with
+    | Some ms ->
+      ms := m :: !ms
+    | None ->
+      if not (get_bool "warn.deterministic") then
+        print m;
+      Table.add m
   )
 
 let final_table: unit Table.MH.t = Table.MH.create 13
@@ -257,9 +420,12 @@ let add_final m =
 
 let finalize () =
   if get_bool "warn.deterministic" then (
-    !Table.messages_list
-    |> List.sort Message.compare
-    |> List.iter print
+    if !Table.Stream.enabled then
+      Table.Stream.iter print (* already sorted by merge *)
+    else
+      !Table.messages_list
+      |> List.sort Message.compare
+      |> List.iter print
   );
   Table.MH.to_seq_keys final_table
   |> List.of_seq
@@ -0,0 +1,116 @@
+(** Sampling profiler attributing analysis time to analyzed functions.
+
+    A wall-clock timer signal periodically records the node and context, which are currently being evaluated, together with the analysis phase.
+    Unlike [Timing.Program], this has no per-evaluation overhead. *)
+
+type sample = {
+  time: float;
+  phases: string list;
+  node: Node.t option;
+  context: int option;
+}
+
+let enabled = ref false
+
+(** Stack of analysis phases, innermost first. *)
+let phases: string list ref = ref []
+
+let start_time = ref 0.
+let count = ref 0
+let keep_samples = ref false
+let samples: sample list ref = ref []
+
+module Stack =
+struct
+  type t = string list * Node.t option [@@deriving eq, hash] (* phases, innermost first, and node *)
+end
+
+module StackH = Hashtbl.Make (Stack)
+
+(** Sample counts by stack. *)
+let folded: int StackH.t = StackH.create 113
+
+(* Names are only resolved when writing outputs, to keep the signal handler cheap. *)
+let take_sample () =
+  let node = !Node.current_node in
+  let context = Option.map ControlSpecC.tag !Messages.current_context in
+  let stack = (!phases, node) in
+  incr count;
+  StackH.replace folded stack (1 + Option.value ~default:0 (StackH.find_opt folded stack));
+  if !keep_samples then
+    samples := {time = Unix.gettimeofday () -. !start_time; phases = !phases; node; context} :: !samples
+
+(** Function name and node id. *)
+let names = function
+  | Some node ->
+    let fundec = try (Node.find_fundec node).svar.vname with Not_found -> "?" in
+    fundec, Node.show_id node
+  | None -> "-", "-"
+
+let wrap_phase name f x =
+  if !enabled then (
+    phases := name :: !phases;
+    Fun.protect ~finally:(fun () -> phases := List.tl !phases) (fun () -> f x)
+  )
+  else
+    f x
+
+let interval () = float_of_int (GobConfig.get_int "dbg.timing.sampling.interval") /. 1000.
+
+(** Start sampling, if enabled by [dbg.timing.sampling.interval]. *)
+let start () =
+  let it = interval () in
+  if it > 0. then (
+    enabled := true;
+    keep_samples := GobConfig.get_string "dbg.timing.sampling.tef" <> "";
+    start_time := Unix.gettimeofday ();
+    (* https://ocaml.org/api/Unix.html#TYPEinterval_timer ITIMER_REAL is wall time; sends sigalrm; ITIMER_PROF and ITIMER_VIRTUAL are already used by Timeout and dbg.solver-stats-interval *)
+    Sys.set_signal Sys.sigalrm (Signal_handle (fun _ -> take_sample ()));
+    ignore Unix.(setitimer ITIMER_REAL { it_interval = it; it_value = it })
+  )
+
+let write_folded filename =
+  let oc = open_out filename in
+  StackH.iter (fun (phases, node) n ->
+      let fundec, node = names node in
+      Printf.fprintf oc "%s %d\n" (String.concat ";" (List.rev_append phases [fundec; node])) n
+    ) folded;
+  close_out oc
+
+let write_tef filename =
+  let dur = interval () *. 1e6 in
+  let event s =
+    let fundec, node = names s.node in
+    `Assoc [
+      ("name", `String fundec);
+      ("cat", `String (String.concat ";" (List.rev s.phases)));
+      ("ph", `String "X");
+      ("ts", `Float (s.time *. 1e6));
+      ("dur", `Float dur);
+      ("pid", `Int 0);
+      ("tid", `Int 0);
+      ("args", `Assoc [
+          ("node", `String node);
+          ("context", match s.context with Some tag -> `Int tag | None -> `Null);
+        ]);
+    ]
+  in
+  Yojson.Safe.to_file filename (`List (List.rev_map event !samples))
+
+(** Stop sampling and write outputs. *)
+let stop () =
+  if !enabled then (
+    ignore Unix.(setitimer ITIMER_REAL { it_interval = 0.; it_value = 0. });
+    Sys.set_signal Sys.sigalrm Signal_default;
+    enabled := false;
+    Logs.info "Sampling profiler: %d samples" !count;
+    let folded_filename = GobConfig.get_string "dbg.timing.sampling.folded" in
+    if folded_filename <> "" then
+      write_folded folded_filename;
+    let tef_filename = GobConfig.get_string "dbg.timing.sampling.tef" in
+    if tef_filename <> "" then
+      write_tef tef_filename;
+    StackH.reset folded;
+    samples := [];
+    count := 0
+  )
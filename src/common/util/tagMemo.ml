@@ -0,0 +1,54 @@
+(** Bounded memoization of binary operations keyed on pairs of hashcons tags. *)
+
+type stats = {
+  name: string;
+  mutable hits: int;
+  mutable misses: int;
+}
+
+(** All caches created so far, for statistics. *)
+let registered: stats list ref = ref []
+
+let register name =
+  let stats = {name; hits = 0; misses = 0} in
+  registered := stats :: !registered;
+  stats
+
+(** Direct-mapped cache: each pair of tags maps to a single slot, which is overwritten on collision.
+    Tags are never reused, so stale entries can only be missed, never wrongly hit. *)
+module Make (V: sig type t end) =
+struct
+  type entry = {
+    tag1: int;
+    tag2: int;
+    value: V.t;
+  }
+
+  type t = {
+    entries: entry option array;
+    stats: stats;
+  }
+
+  (** Size is rounded up to a power of two. Non-positive size disables caching. *)
+  let create ~name size =
+    let rec pow2 n = if n >= size then n else pow2 (2 * n) in
+    let entries = if size > 0 then Array.make (pow2 1) None else [||] in
+    {entries; stats = register name}
+
+  let find_or_add m tag1 tag2 f =
+    let n = Array.length m.entries in
+    if n = 0 then
+      f ()
+    else (
+      let i = (tag1 * 65599 + tag2) land (n - 1) in
+      match m.entries.(i) with
+      | Some e when e.tag1 = tag1 && e.tag2 = tag2 ->
+        m.stats.hits <- m.stats.hits + 1;
+        e.value
+      | _ ->
+        m.stats.misses <- m.stats.misses + 1;
+        let value = f () in
+        m.entries.(i) <- Some {tag1; tag2; value};
+        value
+    )
+end
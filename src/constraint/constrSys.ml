@@ -74,7 +74,6 @@ module type GenericEqIncrSolverBase =
   sig
     type marshal
 
-    val copy_marshal: marshal -> marshal
     val relift_marshal: marshal -> marshal
 
     (** The hash-map that is the first component of [solve xs vs] is a local solution for interesting variables [vs],
@@ -115,7 +114,6 @@ module type GenericGlobSolver =
   sig
     type marshal
 
-    val copy_marshal: marshal -> marshal
     val relift_marshal: marshal -> marshal
 
     (** The hash-map that is the first component of [solve xs vs] is a local solution for interesting variables [vs],
@@ -253,14 +251,13 @@ module GlobSolverFromEqSolver (Sol:GenericEqIncrSolverBase)
     struct
       module EqSys = EqConstrSysFromGlobConstrSys (S)
 
-      module VH : Hashtbl.S with type key=EqSys.v = Hashtbl.Make(EqSys.Var)
+      module VH : Hashtbl.S with type key=EqSys.v = HashtblJournal.Make (EqSys.Var) (* journaled for server mode, if registered by solver *)
       module Sol' = Sol (EqSys) (VH)
 
       module Splitter = GlobConstrSolFromEqConstrSolBase (S) (LH) (GH) (VH) (* reuse EqSys and VH *)
 
       type marshal = Sol'.marshal
 
-      let copy_marshal = Sol'.copy_marshal
       let relift_marshal = Sol'.relift_marshal
 
       let solve ls gs l old_data =
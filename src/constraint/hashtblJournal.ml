@@ -0,0 +1,122 @@
+(** Undo log for hashtables of solver data.
+
+    Server mode must be able to abort an analysis and reuse the previous solver data unmodified.
+    Instead of copying all solver hashtables before each analysis, the solver {!register}s the {!Make} hashtables of its old data
+    and their mutations are journaled during a {!transaction}, such that rolling back costs time proportional to the changed keys.
+    Tables created during the transaction, e.g. temporary ones, aren't registered and thus not journaled. *)
+
+open Batteries
+
+let active = ref false
+
+(** Undo actions, most recent first. *)
+let undos: (unit -> unit) list ref = ref []
+
+let record undo =
+  undos := undo :: !undos
+
+(** Registered table with its journaled keys.
+    [Obj.t] because tables of different {!Make} instances and value types are registered. *)
+type entry = {
+  table: Obj.t;
+  mutable touched: Obj.t option; (** [unit H.t] of keys, whose first change has been journaled. *)
+  mutable saved: bool; (** All bindings have been saved, so no further changes need to be journaled. *)
+}
+
+let registered: entry list ref = ref []
+
+(** Journal mutations of table (of some {!Make} instance) during the current transaction.
+    Must be called before its first mutation in the transaction. *)
+let register table =
+  if !active && not (List.exists (fun e -> e.table == Obj.repr table) !registered) then
+    registered := {table = Obj.repr table; touched = None; saved = false} :: !registered
+
+let finish () =
+  active := false;
+  undos := [];
+  registered := []
+
+(** [transaction f x] evaluates [f x], while journaling mutations of all {!register}ed hashtables.
+    If it raises, e.g. [Sys.Break] when aborted, the mutations are undone.
+
+    The undo log only restores old bindings of tables, which are themselves intact.
+    An asynchronous exception, like [Sys.Break] on an interactive abort, can arrive in the middle of a [Hashtbl] operation, e.g. while resizing moves bindings between buckets in place.
+    The old data of that table can then already be corrupted before the undo log runs, which copying all tables before the transaction didn't suffer from. *)
+let transaction f x =
+  assert (not !active);
+  active := true;
+  match f x with
+  | r ->
+    finish ();
+    r
+  | exception e ->
+    let bt = Printexc.get_raw_backtrace () in
+    active := false;
+    List.iter (fun undo -> undo ()) !undos;
+    finish ();
+    Printexc.raise_with_backtrace e bt
+
+(** Hashtable, whose mutations are journaled during a {!transaction}, if it is {!register}ed.
+    Mutations via the [Labels] and [Exceptionless] submodules aren't journaled. *)
+module Make (Key: Hashtbl.HashedType): Hashtbl.S with type key = Key.t =
+struct
+  module H = Hashtbl.Make (Key)
+  include H
+
+  let find_entry t =
+    if !active then
+      List.find_opt (fun e -> e.table == Obj.repr t) !registered
+    else
+      None
+
+  (* Restoring all bindings is only needed for bulk mutations, which are rare on non-empty solver data. *)
+  let restore_all t =
+    match find_entry t with
+    | Some e when not e.saved ->
+      e.saved <- true;
+      let bindings = H.fold (fun k v acc -> (k, v) :: acc) t [] in (* reverses order of shadowed bindings, such that adding restores it *)
+      record (fun () ->
+          H.clear t;
+          List.iter (fun (k, v) -> H.add t k v) bindings
+        )
+    | _ -> ()
+
+  (* Only the first change of a key is journaled, so the log is proportional to the changed keys, not to the number of updates. *)
+  let restore t k =
+    match find_entry t with
+    | Some e when not e.saved ->
+      let touched: unit H.t = match e.touched with
+        | Some touched -> Obj.obj touched
+        | None ->
+          let touched = H.create 113 in
+          e.touched <- Some (Obj.repr touched);
+          touched
+      in
+      if not (H.mem touched k) then (
+        H.replace touched k ();
+        let old = H.find_all t k in (* most recent first *)
+        record (fun () ->
+            while H.mem t k do
+              H.remove t k
+            done;
+            List.iter (H.add t k) (List.rev old)
+          )
+      )
+    | _ -> ()
+
+  let add t k v = restore t k; H.add t k v
+  let remove t k = restore t k; H.remove t k
+  let replace t k v = restore t k; H.replace t k v
+  let modify k f t = restore t k; H.modify k f t
+  let modify_def v k f t = restore t k; H.modify_def v k f t
+  let modify_opt k f t = restore t k; H.modify_opt k f t
+  let remove_all t k = restore t k; H.remove_all t k
+  let add_seq t s = Seq.iter (fun (k, v) -> add t k v) s
+  let replace_seq t s = Seq.iter (fun (k, v) -> replace t k v) s
+  let clear t = restore_all t; H.clear t
+  let reset t = restore_all t; H.reset t
+  let map_inplace f t = restore_all t; H.map_inplace f t
+  let filter_inplace f t = restore_all t; H.filter_inplace f t
+  let filteri_inplace f t = restore_all t; H.filteri_inplace f t
+  let filter_map_inplace f t = restore_all t; H.filter_map_inplace f t
+end
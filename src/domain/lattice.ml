@@ -145,16 +145,27 @@ struct
 end
 
 (* HAS SIDE-EFFECTS ---- PLEASE INSTANCIATE ONLY ONCE!!! *)
-module HConsed (Base:S) (Arg: sig val assume_idempotent: bool end) =
+(** Binary operations are memoized on tag pairs in caches of [Arg.memo_size] entries each (non-positive disables). *)
+module HConsed (Base:S) (Arg: sig val assume_idempotent: bool val memo_size: int end) =
 struct
   include Printable.HConsed (Base)
 
+  module Memo = TagMemo.Make (struct type nonrec t = t end)
+  module LeqMemo = TagMemo.Make (Bool)
+  let memo_name op = op ^ " " ^ Base.name ()
+  let narrow_memo = Memo.create ~name:(memo_name "narrow") Arg.memo_size
+  let widen_memo = Memo.create ~name:(memo_name "widen") Arg.memo_size
+  let meet_memo = Memo.create ~name:(memo_name "meet") Arg.memo_size
+  let join_memo = Memo.create ~name:(memo_name "join") Arg.memo_size
+  let leq_memo = LeqMemo.create ~name:(memo_name "leq") Arg.memo_size
+
   let lift_f2 f x y = f (unlift x) (unlift y)
-  let narrow x y = if Arg.assume_idempotent && x.BatHashcons.tag = y.BatHashcons.tag then x else lift (lift_f2 Base.narrow x y)
-  let widen x y = if x.BatHashcons.tag = y.BatHashcons.tag then x else lift (lift_f2 Base.widen x y)
-  let meet x y = if Arg.assume_idempotent && x.BatHashcons.tag = y.BatHashcons.tag then x else lift (lift_f2 Base.meet x y)
-  let join x y = if x.BatHashcons.tag = y.BatHashcons.tag then x else lift (lift_f2 Base.join x y)
-  let leq x y = (x.BatHashcons.tag = y.BatHashcons.tag) || lift_f2 Base.leq x y
+  let memo_lift_f2 memo f x y = Memo.find_or_add memo x.BatHashcons.tag y.BatHashcons.tag (fun () -> lift (lift_f2 f x y))
+  let narrow x y = if Arg.assume_idempotent && x.BatHashcons.tag = y.BatHashcons.tag then x else memo_lift_f2 narrow_memo Base.narrow x y
+  let widen x y = if x.BatHashcons.tag = y.BatHashcons.tag then x else memo_lift_f2 widen_memo Base.widen x y
+  let meet x y = if Arg.assume_idempotent && x.BatHashcons.tag = y.BatHashcons.tag then x else memo_lift_f2 meet_memo Base.meet x y
+  let join x y = if x.BatHashcons.tag = y.BatHashcons.tag then x else memo_lift_f2 join_memo Base.join x y
+  let leq x y = (x.BatHashcons.tag = y.BatHashcons.tag) || LeqMemo.find_or_add leq_memo x.BatHashcons.tag y.BatHashcons.tag (fun () -> lift_f2 Base.leq x y)
   let is_top = lift_f Base.is_top
   let is_bot = lift_f Base.is_bot
   let top () = lift (Base.top ())
@@ -163,6 +174,43 @@ struct
   let pretty_diff () (x,y) = Base.pretty_diff () (x.BatHashcons.obj,y.BatHashcons.obj)
 end
 
+(** Lattice for {!Printable.HConsedOpt}.
+    [join] and [leq] of tagged values are memoized on tag pairs in a cache of [Arg.memo_size] entries. *)
+module HConsedOpt (Base:S) (Arg: sig val name: string val enabled: unit -> bool val memo_size: int end) =
+struct
+  include Printable.HConsedOpt (Base) (Arg)
+
+  module JoinMemo = TagMemo.Make (struct type nonrec t = t end)
+  module LeqMemo = TagMemo.Make (Bool)
+  let join_memo = JoinMemo.create ~name:("join " ^ Arg.name) Arg.memo_size
+  let leq_memo = LeqMemo.create ~name:("leq " ^ Arg.name) Arg.memo_size
+
+  let lift_f2 f x y = f (unlift x) (unlift y)
+  let join x y =
+    if is_tagged x && is_tagged y then (
+      if x.tag = y.tag then
+        x
+      else
+        JoinMemo.find_or_add join_memo x.tag y.tag (fun () -> lift (lift_f2 Base.join x y))
+    )
+    else
+      lift (lift_f2 Base.join x y)
+  let leq x y =
+    if is_tagged x && is_tagged y then
+      x.tag = y.tag || LeqMemo.find_or_add leq_memo x.tag y.tag (fun () -> lift_f2 Base.leq x y)
+    else
+      x == y || lift_f2 Base.leq x y
+  let widen x y = if is_tagged x && x.tag = y.tag then x else lift (lift_f2 Base.widen x y)
+  let meet x y = lift (lift_f2 Base.meet x y)
+  let narrow x y = lift (lift_f2 Base.narrow x y)
+  let is_top = lift_f Base.is_top
+  let is_bot = lift_f Base.is_bot
+  let top () = lift (Base.top ())
+  let bot () = lift (Base.bot ())
+
+  let pretty_diff () (x,y) = Base.pretty_diff () (x.obj,y.obj)
+end
+
 module HashCached (M: S) =
 struct
   include Printable.HashCached (M)
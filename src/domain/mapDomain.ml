@@ -208,6 +208,213 @@ struct
       ) m M.empty
 end
 
+(** Map represented by an array of bindings sorted by key.
+    Compared to {!PMap}, it is more compact and faster to join for small maps, which are mostly read and joined,
+    but [add] and [remove] copy the whole array.
+    Operations return their argument physically, if no binding changed. *)
+module PArray (Domain: Printable.S) (Range: Lattice.S) : PS with
+  type key = Domain.t and
+  type value = Range.t =
+struct
+  include Printable.Std
+  type key = Domain.t
+  type value = Range.t
+  type t = (key * value) array (* sorted by key, without duplicate keys *)
+
+  let name () = "map"
+
+  (** Index of the binding of [k] in [m] or [-(i + 1)], if it is missing and should be inserted at index [i]. *)
+  let search k (m: t) =
+    let rec bsearch lo hi =
+      if lo >= hi then
+        -(lo + 1)
+      else (
+        let mid = (lo + hi) / 2 in
+        let c = Domain.compare k (fst m.(mid)) in
+        if c = 0 then
+          mid
+        else if c < 0 then
+          bsearch lo mid
+        else
+          bsearch (mid + 1) hi
+      )
+    in
+    bsearch 0 (Array.length m)
+
+  let physically_equal (m1: t) (m2: t) =
+    m1 == m2 || (Array.length m1 = Array.length m2 && Array.for_all2 (fun (k1, v1) (k2, v2) -> k1 == k2 && v1 == v2) m1 m2)
+
+  let equal (x: t) (y: t) =
+    x == y || (Array.length x = Array.length y && Array.for_all2 (fun (k1, v1) (k2, v2) -> Domain.equal k1 k2 && Range.equal v1 v2) x y)
+  let compare (x: t) (y: t) =
+    if x == y then
+      0
+    else (
+      let n = Array.length x in
+      let rec compare_from i =
+        if i = n then
+          0
+        else (
+          let (k1, v1) = x.(i) in
+          let (k2, v2) = y.(i) in
+          let c = Domain.compare k1 k2 in
+          if c <> 0 then
+            c
+          else (
+            let c = Range.compare v1 v2 in
+            if c <> 0 then c else compare_from (i + 1)
+          )
+        )
+      in
+      let c = Int.compare n (Array.length y) in
+      if c <> 0 then c else compare_from 0
+    )
+  let hash (xs: t) = Array.fold_left (fun a (k, v) -> a + (Domain.hash k * Range.hash v)) 0 xs
+
+  let empty (): t = [||]
+  let is_empty (m: t) = Array.length m = 0
+  let cardinal (m: t) = Array.length m
+  let singleton k v: t = [|(k, v)|]
+  let choose (m: t) = if is_empty m then raise Not_found else m.(0)
+  let bindings (m: t) = Array.to_list m
+
+  let find k m =
+    let i = search k m in
+    if i >= 0 then snd m.(i) else raise Not_found
+  let find_opt k m =
+    let i = search k m in
+    if i >= 0 then Some (snd m.(i)) else None
+  let mem k m = search k m >= 0
+
+  let add k v m =
+    let i = search k m in
+    if i >= 0 then (
+      if snd m.(i) == v then
+        m
+      else (
+        let m' = Array.copy m in
+        m'.(i) <- (k, v);
+        m'
+      )
+    )
+    else (
+      let i = -(i + 1) in
+      Array.init (Array.length m + 1) (fun j ->
+          if j < i then m.(j) else if j = i then (k, v) else m.(j - 1)
+        )
+    )
+
+  let remove k m =
+    let i = search k m in
+    if i < 0 then
+      m
+    else
+      Array.init (Array.length m - 1) (fun j -> if j < i then m.(j) else m.(j + 1))
+
+  let iter f (m: t) = Array.iter (fun (k, v) -> f k v) m
+  let fold f (m: t) a = Array.fold_left (fun a (k, v) -> f k v a) a m
+  let for_all f (m: t) = Array.for_all (fun (k, v) -> f k v) m
+  let exists f (m: t) = Array.exists (fun (k, v) -> f k v) m
+
+  let mapi f (m: t) =
+    let m' = Array.map (fun ((k, v) as b) ->
+        let v' = f k v in
+        if v' == v then b else (k, v')
+      ) m
+    in
+    if physically_equal m m' then m else m'
+  let map f = mapi (fun _ v -> f v)
+
+  let filter f (m: t) =
+    let kept = List.filter (fun (k, v) -> f k v) (Array.to_list m) in
+    if List.compare_length_with kept (Array.length m) = 0 then m else Array.of_list kept
+
+  (* Merges sorted bindings in one pass, reusing [m1] or [m2], if the result is physically equal to them. *)
+  let merge f (m1: t) (m2: t): t =
+    let n1 = Array.length m1 in
+    let n2 = Array.length m2 in
+    let cons ((k, v) as b) r acc =
+      match r with
+      | Some v' when v' == v -> b :: acc
+      | Some v' -> (k, v') :: acc
+      | None -> acc
+    in
+    let rec merge_from i1 i2 acc =
+      if i1 < n1 && i2 < n2 then (
+        let (k1, v1) as b1 = m1.(i1) in
+        let (k2, v2) as b2 = m2.(i2) in
+        let c = Domain.compare k1 k2 in
+        if c = 0 then
+          merge_from (i1 + 1) (i2 + 1) (cons b1 (f k1 (Some v1) (Some v2)) acc)
+        else if c < 0 then
+          merge_from (i1 + 1) i2 (cons b1 (f k1 (Some v1) None) acc)
+        else
+          merge_from i1 (i2 + 1) (cons b2 (f k2 None (Some v2)) acc)
+      )
+      else if i1 < n1 then (
+        let (k1, v1) as b1 = m1.(i1) in
+        merge_from (i1 + 1) i2 (cons b1 (f k1 (Some v1) None) acc)
+      )
+      else if i2 < n2 then (
+        let (k2, v2) as b2 = m2.(i2) in
+        merge_from i1 (i2 + 1) (cons b2 (f k2 None (Some v2)) acc)
+      )
+      else
+        acc
+    in
+    let m = Array.of_list (List.rev (merge_from 0 0 [])) in
+    if physically_equal m m1 then
+      m1
+    else if physically_equal m m2 then
+      m2
+    else
+      m
+
+  let add_list keyvalues m =
+    List.fold_left (fun acc (key,value) -> add key value acc) m keyvalues
+
+  let add_list_set keys value m =
+    List.fold_left (fun acc key -> add key value acc) m keys
+
+  let add_list_fun keys f m =
+    List.fold_left (fun acc key -> add key (f key) acc) m keys
+
+  let long_map2 op =
+    let f k v1 v2 =
+      match v1, v2 with
+      | Some v1, Some v2 -> Some (op v1 v2)
+      | Some _, _ -> v1
+      | _, Some _ -> v2
+      | _ -> None
+    in
+    merge f
+
+  let map2 op =
+    let f k v1 v2 =
+      match v1, v2 with
+      | Some v1, Some v2 -> Some (op v1 v2)
+      | _ -> None
+    in
+    merge f
+
+  include Print (Domain) (Range) (
+    struct
+      type nonrec t = t
+      type nonrec key = key
+      type nonrec value = value
+      let fold = fold
+      let iter = iter
+    end
+    )
+
+  let arbitrary () = QCheck.always (empty ()) (* S TODO: non-empty map *)
+
+  let relift (m: t): t =
+    let m' = Array.map (fun (k, v) -> (Domain.relift k, Range.relift v)) m in
+    Array.stable_sort (fun (k1, _) (k2, _) -> Domain.compare k1 k2) m';
+    m'
+end
+
 (* TODO: why is HashCached.hash significantly slower as a functor compared to being inlined into PMap? *)
 module HashCached (M: S) : S with
   type key = M.key and
@@ -263,7 +470,7 @@ module HConsed (M: S) : S with
   type key = M.key and
   type value = M.value =
 struct
-  include Lattice.HConsed (M) (struct let assume_idempotent = false end)
+  include Lattice.HConsed (M) (struct let assume_idempotent = false let memo_size = 0 end)
 
   type key = M.key
   type value = M.value
@@ -382,11 +589,12 @@ struct
   let relift x = M.relift x
 end
 
-module MapBot (Domain: Printable.S) (Range: Lattice.S) : S with
+(** Map lattice with bottom as the default value, using the map representation [M]. *)
+module MapBotOf (Domain: Printable.S) (Range: Lattice.S) (M: PS with type key = Domain.t and type value = Range.t) : S with
   type key = Domain.t and
   type value = Range.t =
 struct
-  include PMap (Domain) (Range)
+  include M
 
   let leq_with_fct f m1 m2 =
     (* For each key-value in m1, the same key must be in m2 with a geq value: *)
@@ -431,6 +639,17 @@ struct
   let narrow = map2 Range.narrow
 end
 
+module MapBot (Domain: Printable.S) (Range: Lattice.S) : S with
+  type key = Domain.t and
+  type value = Range.t =
+  MapBotOf (Domain) (Range) (PMap (Domain) (Range))
+
+(** Like {!MapBot}, but using {!PArray}. *)
+module ArrayMapBot (Domain: Printable.S) (Range: Lattice.S) : S with
+  type key = Domain.t and
+  type value = Range.t =
+  MapBotOf (Domain) (Range) (PArray (Domain) (Range))
+
 module MapTop (Domain: Printable.S) (Range: Lattice.S) : S with
   type key = Domain.t and
   type value = Range.t =
@@ -611,6 +830,50 @@ struct
 end
 
 
+(** Optionally hashconsed map domain, see {!Lattice.HConsedOpt}. *)
+(* HAS SIDE-EFFECTS ---- PLEASE INSTANCIATE ONLY ONCE!!! *)
+module HConsedOpt (M: S) (Arg: sig val name: string val enabled: unit -> bool val memo_size: int end) : S with
+  type key = M.key and
+  type value = M.value =
+struct
+  include Lattice.HConsedOpt (M) (Arg)
+
+  type key = M.key
+  type value = M.value
+
+  let add k v x = lift_if_changed x (M.add k v (unlift x))
+  let remove k x = lift_if_changed x (M.remove k (unlift x))
+  let find k = lift_f (M.find k)
+  let find_opt k = lift_f (M.find_opt k)
+  let mem k = lift_f (M.mem k)
+  let iter f = lift_f (M.iter f)
+  let map f x = lift_if_changed x (M.map f (unlift x))
+  let mapi f x = lift_if_changed x (M.mapi f (unlift x))
+  let fold f x a = M.fold f (unlift x) a
+  let filter f x = lift_if_changed x (M.filter f (unlift x))
+  let merge f x y = lift (lift_f2 (M.merge f) x y)
+  let for_all f = lift_f (M.for_all f)
+
+  let cardinal = lift_f M.cardinal
+  let choose = lift_f M.choose
+  let singleton k v = lift (M.singleton k v)
+  let empty () = lift (M.empty ())
+  let is_empty = lift_f M.is_empty
+  let exists p = lift_f (M.exists p)
+  let bindings = lift_f M.bindings
+
+  let add_list keyvalues x = lift_if_changed x (M.add_list keyvalues (unlift x))
+  let add_list_set keys value x = lift_if_changed x (M.add_list_set keys value (unlift x))
+  let add_list_fun keys f x = lift_if_changed x (M.add_list_fun keys f (unlift x))
+
+  let long_map2 op x y = lift (lift_f2 (M.long_map2 op) x y)
+  let map2 op x y = lift (lift_f2 (M.map2 op) x y)
+
+  let leq_with_fct f = lift_f2 (M.leq_with_fct f)
+  let join_with_fct f x y = lift (lift_f2 (M.join_with_fct f) x y)
+  let widen_with_fct f x y = lift (lift_f2 (M.widen_with_fct f) x y)
+end
+
 module LiftBot (Range: Lattice.S) (M: S with type value = Range.t): S with
   type key = M.key and
   type value = Range.t =
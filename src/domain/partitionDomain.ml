@@ -192,4 +192,14 @@ struct
       BatPrintf.fprintf f "</map>\n</value>\n"
 end
 
-module ExpPartitions = SetSet (CilType.Exp)
+(** Partitions of interned expressions, see {!Basetype.InternedExp}.
+    Operations with expression arguments intern them. *)
+module ExpPartitions =
+struct
+  module Exp = Basetype.InternedExp
+  include SetSet (Exp)
+
+  let add_eq (x, y) ss = add_eq (Exp.of_exp x, Exp.of_exp y) ss
+  let filter f ss = filter (fun x -> f (Exp.to_exp x)) ss
+  let find_class x ss = find_class (Exp.of_exp x) ss
+end
@@ -429,6 +429,41 @@ struct
     iter (Base.printXml f) xs
 end
 
+(** Optionally hashconsed set domain, see {!Lattice.HConsedOpt}. *)
+(* HAS SIDE-EFFECTS ---- PLEASE INSTANCIATE ONLY ONCE!!! *)
+module HConsedOpt (Base: S) (Arg: sig val name: string val enabled: unit -> bool val memo_size: int end): S with type elt = Base.elt =
+struct
+  include Lattice.HConsedOpt (Base) (Arg)
+  type elt = Base.elt
+
+  let empty () = lift (Base.empty ())
+  let is_empty = lift_f Base.is_empty
+  let mem e = lift_f (Base.mem e)
+  let add e x = lift_if_changed x (Base.add e (unlift x))
+  let singleton e = lift (Base.singleton e)
+  let remove e x = lift_if_changed x (Base.remove e (unlift x))
+  let union x y = lift (Base.union (unlift x) (unlift y))
+  let inter x y = lift (Base.inter (unlift x) (unlift y))
+  let diff x y = lift_if_changed x (Base.diff (unlift x) (unlift y))
+  let subset x y = equal x y || Base.subset (unlift x) (unlift y)
+  let disjoint x y = Base.disjoint (unlift x) (unlift y)
+  let iter f = lift_f (Base.iter f)
+  let map f x = lift_if_changed x (Base.map f (unlift x))
+  let fold f x a = Base.fold f (unlift x) a
+  let for_all p = lift_f (Base.for_all p)
+  let exists p = lift_f (Base.exists p)
+  let filter p x = lift_if_changed x (Base.filter p (unlift x))
+  let partition p x =
+    let (a, b) = Base.partition p (unlift x) in
+    (lift_if_changed x a, lift b)
+  let cardinal = lift_f Base.cardinal
+  let elements = lift_f Base.elements
+  let of_list es = lift (Base.of_list es)
+  let min_elt = lift_f Base.min_elt
+  let max_elt = lift_f Base.max_elt
+  let choose = lift_f Base.choose
+end
+
 (** Reverses lattice order of a set domain while keeping the set operations same. *)
 module Reverse (Base: S) =
 struct
@@ -574,6 +574,12 @@ let race_conf accs =
 
 let is_all_safe = ref true
 
+let () =
+  ForkPool.register
+    ~reset:(fun () -> is_all_safe := true)
+    ~get:(fun () -> !is_all_safe)
+    ~merge:(fun all_safe -> is_all_safe := !is_all_safe && all_safe)
+
 (* Commenting your code is for the WEAK! *)
 let incr_summary ~safe ~vulnerable ~unsafe grouped_accs =
   (* ignore(printf "Checking safety of %a:\n" d_memo (ty,lv)); *)
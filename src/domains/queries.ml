@@ -134,6 +134,8 @@ type _ t =
   | YamlEntryGlobal: Obj.t * YamlWitnessType.Task.t -> YS.t t (** YAML witness entries for a global unknown ([Obj.t] represents [Spec.V.t]) and YAML witness task. *)
   | GhostVarAvailable: WitnessGhostVar.t -> MayBool.t t
   | InvariantGlobalNodes: NS.t t (** Nodes where YAML witness flow-insensitive invariants should be emitted as location invariants (if [witness.invariant.flow_insensitive-as] is configured to do so). *) (* [Spec.V.t] argument (as [Obj.t]) could be added, if this should be different for different flow-insensitive invariants. *)
+  | IterLocalComponents: (string -> Obj.t -> unit) -> Unit.t t (** Iterate over named components of local state and context, e.g. per analysis for [dbg.heap-breakdown]. *)
+  | IterGlobalComponents: Obj.t * (string -> Obj.t -> unit) -> Unit.t t (** Iterate over named components of a global unknown ([Obj.t] represents [Spec.V.t]). *)
 
 type 'a result = 'a
 
@@ -209,6 +211,8 @@ struct
     | YamlEntryGlobal _ -> (module YS)
     | GhostVarAvailable _ -> (module MayBool)
     | InvariantGlobalNodes -> (module NS)
+    | IterLocalComponents _ -> (module Unit)
+    | IterGlobalComponents _ -> (module Unit)
 
   (** Get bottom result for query. *)
   let bot (type a) (q: a t): a result =
@@ -283,6 +287,8 @@ struct
     | YamlEntryGlobal _ -> YS.top ()
     | GhostVarAvailable _ -> MayBool.top ()
     | InvariantGlobalNodes -> NS.top ()
+    | IterLocalComponents _ -> Unit.top ()
+    | IterGlobalComponents _ -> Unit.top ()
 end
 
 (* The type any_query can't be directly defined in Any as t,
@@ -354,6 +360,8 @@ struct
     | Any (MustProtectingLocks _) -> 61
     | Any (GhostVarAvailable _) -> 62
     | Any InvariantGlobalNodes -> 63
+    | Any (IterLocalComponents _) -> 64
+    | Any (IterGlobalComponents _) -> 65
 
   let rec compare a b =
     let r = Stdlib.compare (order a) (order b) in
@@ -412,6 +420,7 @@ struct
       | Any (MaySignedOverflow e1), Any (MaySignedOverflow e2) -> CilType.Exp.compare e1 e2
       | Any (GasExhausted f1), Any (GasExhausted f2) -> CilType.Fundec.compare f1 f2
       | Any (GhostVarAvailable v1), Any (GhostVarAvailable v2) -> WitnessGhostVar.compare v1 v2
+      | Any (IterGlobalComponents (vi1, _)), Any (IterGlobalComponents (vi2, _)) -> Stdlib.compare (Hashtbl.hash vi1) (Hashtbl.hash vi2) (* not comparing fs *)
       (* only argumentless queries should remain *)
       | _, _ -> Stdlib.compare (order a) (order b)
 
@@ -458,6 +467,7 @@ struct
     | Any (MaySignedOverflow e) -> CilType.Exp.hash e
     | Any (GasExhausted f) -> CilType.Fundec.hash f
     | Any (GhostVarAvailable v) -> WitnessGhostVar.hash v
+    | Any (IterGlobalComponents (vi, _)) -> Hashtbl.hash vi
     (* IterSysVars:                                                                    *)
     (*   - argument is a function and functions cannot be compared in any meaningful way. *)
     (*   - doesn't matter because IterSysVars is always queried from outside of the analysis, so MCP's query caching is not done for it. *)
@@ -526,6 +536,8 @@ struct
     | Any (GasExhausted f) -> Pretty.dprintf "GasExhausted %a" CilType.Fundec.pretty f
     | Any (GhostVarAvailable v) -> Pretty.dprintf "GhostVarAvailable %a" WitnessGhostVar.pretty v
     | Any InvariantGlobalNodes -> Pretty.dprintf "InvariantGlobalNodes"
+    | Any (IterLocalComponents _) -> Pretty.dprintf "IterLocalComponents _"
+    | Any (IterGlobalComponents _) -> Pretty.dprintf "IterGlobalComponents _"
 end
 
 let to_value_domain_ask (ask: ask) =
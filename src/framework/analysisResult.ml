@@ -97,7 +97,7 @@ struct
         BatPrintf.fprintf f "<group name=\"%s%s\">%a</group>\n" n group_loc_text (BatList.print ~first:"" ~last:"" ~sep:"" one_text) e
     in
     let one_w f x = BatPrintf.fprintf f "\n<warning>%a</warning>" one_w x in
-    List.iter (one_w f) !Messages.Table.messages_list
+    Messages.Table.iter (one_w f)
 
   let output table gtable gtfxml (file: file) =
     let out = Messages.get_out result_name !Messages.out in
@@ -180,7 +180,21 @@ struct
         write_file f (get_string "outfile")
     | "sarif" ->
       Logs.result "Writing Sarif to file: %s" (get_string "outfile");
-      Yojson.Safe.to_channel ~std:true out (Sarif.to_yojson (List.rev !Messages.Table.messages_list));
+      if !Messages.Table.Stream.enabled then
+        Sarif.to_channel out Messages.Table.iter
+      else
+        Yojson.Safe.to_channel ~std:true out (Sarif.to_yojson (List.rev !Messages.Table.messages_list));
+    | "json-messages" when !Messages.Table.Stream.enabled ->
+      Printf.fprintf out {|{"files":%s,"messages":[|} (Yojson.Safe.to_string ~std:true (Preprocessor.dependencies_to_yojson ()));
+      let first = ref true in
+      Messages.Table.iter (fun m ->
+          if !first then
+            first := false
+          else
+            output_char out ',';
+          Yojson.Safe.to_channel ~std:true out (Messages.Message.to_yojson m)
+        );
+      Printf.fprintf out "]}"
     | "json-messages" ->
       let json = `Assoc [
           ("files", Preprocessor.dependencies_to_yojson ());
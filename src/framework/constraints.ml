@@ -462,7 +462,8 @@ struct
         )
     in
 
-    let reluctant = GobConfig.get_bool "incremental.reluctant.enabled" in
+    let demand = GobConfig.get_string_list "incremental.demand.funs" <> [] && GobConfig.get_bool "incremental.load" in
+    let reluctant = GobConfig.get_bool "incremental.reluctant.enabled" || demand in
     let reanalyze_entry f =
       (* destabilize the entry points of a changed function when reluctant is off,
          or the function is to be force-reanalyzed  *)
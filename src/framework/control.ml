@@ -61,13 +61,16 @@ let current_varquery_global_state_json: (VarQuery.t option -> Yojson.Safe.t) ref
 module AnalyzeCFG (Cfg:CfgBidirSkip) (Spec:Spec) (Inc:Increment) =
 struct
 
+  (* Per-function summaries exported to and imported from other runs *)
+  module Summaries = Summaries.Make (Spec) (FromSpec (Spec) (Cfg) (Inc))
+
   module SpecSys: SpecSys with module Spec = Spec =
   struct
     (* Must be created in module, because cannot be wrapped in a module later. *)
     module Spec = Spec
 
     (* The Equation system *)
-    module EQSys = FromSpec (Spec) (Cfg) (Inc)
+    module EQSys = Summaries.EQSys
 
     (* Hashtbl for locals *)
     module LHT   = BatHashtbl.Make (EQSys.LVar)
@@ -102,6 +105,49 @@ struct
 
   module Query = ResultQuery.Query (SpecSys)
 
+  (* report reachable words per analysis component, solver table, function and context (see dbg.heap-breakdown) *)
+  let heap_breakdown gh iter_locals iter_globals tables =
+    (* nodes and varinfos reach the whole CIL file and CFG, which aren't attributed to any group *)
+    let baseline = [Obj.repr !Cilfacade.current_file; Obj.repr (module Cfg: CfgBidirSkip)] in
+    let components = HeapBreakdown.create ~baseline () in
+    let functions = HeapBreakdown.create ~baseline () in
+    let contexts = HeapBreakdown.create ~baseline () in
+    (* analysis components come first, such that solver tables only add their keys and metadata *)
+    iter_locals (fun ((n, c) as v: EQSys.LVar.t) (d: EQSys.D.t) ->
+        Query.ask_local gh v d (IterLocalComponents (HeapBreakdown.add components));
+        let fd = Node.find_fundec n in
+        HeapBreakdown.add functions fd.svar.vname (Obj.repr c);
+        HeapBreakdown.add functions fd.svar.vname (Obj.repr d);
+        let name = Printf.sprintf "%s, context %d" fd.svar.vname (Spec.C.hash c) in
+        HeapBreakdown.add contexts name (Obj.repr c);
+        HeapBreakdown.add contexts name (Obj.repr d)
+      );
+    iter_globals (fun (g: EQSys.GVar.t) (v: EQSys.G.t) ->
+        match g with
+        | `Left g' -> (* Spec global *)
+          Query.ask_global_with (fun _ -> v) (IterGlobalComponents (Obj.repr g', HeapBreakdown.add components))
+        | `Right _ -> (* contexts global *)
+          HeapBreakdown.add components "contexts" (Obj.repr v)
+      );
+    List.iter (fun (name, x) -> HeapBreakdown.add components ("solver." ^ name) x) tables;
+    HeapBreakdown.report "Heap breakdown by component" components;
+    let top = get_int "dbg.heap-breakdown.top" in
+    let measure = get_int "dbg.heap-breakdown.measure" in
+    HeapBreakdown.report_top "Heap breakdown by function" ~measure top functions;
+    HeapBreakdown.report_top "Heap breakdown by function and context" ~measure top contexts
+
+  (* heap breakdown of solver data during solving on dbg.solver-signal *)
+  let solver_heap_breakdown () =
+    let iter_unknowns f =
+      !Goblint_solver.SolverStats.heap_iter (fun x d ->
+          f (Obj.obj x: [`L of EQSys.LVar.t | `G of EQSys.GVar.t]) (Obj.obj d: [`Bot | `Lifted1 of EQSys.G.t | `Lifted2 of EQSys.D.t | `Top])
+        )
+    in
+    heap_breakdown (GHT.create 1)
+      (fun f -> iter_unknowns (fun x d -> match x, d with `L x, `Lifted2 d -> f x d | _, _ -> ()))
+      (fun f -> iter_unknowns (fun x d -> match x, d with `G x, `Lifted1 d -> f x d | _, _ -> ()))
+      (!Goblint_solver.SolverStats.heap_tables ())
+
   (* print out information about dead code *)
   let print_dead_code (xs:Result.t) uncalled_fn_loc =
     let module NH = Hashtbl.Make (Node) in
@@ -310,8 +356,8 @@ struct
         ; sideg   = (fun g d -> sideg (EQSys.GVar.spec g) (EQSys.G.create_spec d))
         }
       in
-      let edges = CfgTools.getGlobalInits file in
-      Logs.debug "Executing %d assigns." (List.length edges);
+      let edges, bulk_inits = CfgTools.getGlobalInits file in
+      Logs.debug "Executing %d assigns and %d bulk initializations." (List.length edges) (List.length bulk_inits);
       let funs = ref [] in
       (*let count = ref 0 in*)
       let transfer_func (st : Spec.D.t) (loc, edge) : Spec.D.t =
@@ -338,10 +384,19 @@ struct
           res'
         | _                       -> failwith "Unsupported global initializer edge"
       in
+      let bulk_init (st : Spec.D.t) (loc, var, init) : Spec.D.t =
+        Goblint_tracing.current_loc := loc;
+        if M.tracing then M.trace "global_inits" "GlobalInit %a" CilType.Varinfo.pretty var;
+        let man = {man with local = st} in
+        let res = Spec.event man (Events.GlobalInit {var; init}) man in
+        (* Needed for privatizations (e.g. None) that do not side immediately *)
+        Spec.sync {man with local = res} `Normal
+      in
       let with_externs = do_extern_inits man file in
       (*if (get_bool "dbg.verbose") then Printf.printf "Number of init. edges : %d\nWorking:" (List.length edges);    *)
       let old_loc = !Goblint_tracing.current_loc in
       let result : Spec.D.t = List.fold_left transfer_func with_externs edges in
+      let result = List.fold_left bulk_init result bulk_inits in
       Goblint_tracing.current_loc := old_loc;
       if M.tracing then M.trace "global_inits" "startstate: %a" Spec.D.pretty result;
       result, !funs
@@ -392,6 +447,9 @@ struct
       )
     in
 
+    if get_bool "ana.opt.exp-types" then
+      Timing.wrap "exp_types" Cilfacade.compute_exp_types file;
+
     let startstate, more_funs =
       Logs.debug "Initializing %d globals." (CfgTools.numGlobals file);
       Timing.wrap "global_inits" do_global_inits file
@@ -541,16 +599,25 @@ struct
             match Inc.increment with
             | Some {solver_data; server; _} ->
               if server then
-                Some (Slvr.copy_marshal solver_data) (* Copy, so that we can abort and reuse old data unmodified. *)
-              else if GobConfig.get_bool "ana.opt.hashcons" then
-                Some (Slvr.relift_marshal solver_data)
+                Some solver_data (* Solved in a journaled transaction below, so that we can abort and reuse old data unmodified. *)
               else
-                Some solver_data
+                Some (Slvr.relift_marshal solver_data) (* hashconsed values, at least interned expressions, get their tags from this process *)
             | None -> None
           in
           Logs.debug "%s" ("Solving the constraint system with " ^ get_string "solver" ^ ". Solver statistics are shown every " ^ string_of_int (get_int "dbg.solver-stats-interval") ^ "s or by signal " ^ get_string "dbg.solver-signal" ^ ".");
           AnalysisState.should_warn := get_string "warn_at" = "early" || gobview;
-          let (lh, gh), solver_data = Timing.wrap "solving" (Slvr.solve entrystates entrystates_global startvars') solver_data in
+          Summaries.init ();
+          Sampling.start ();
+          Goblint_solver.SolverStats.heap_breakdown := solver_heap_breakdown;
+          let solve =
+            match Inc.increment with
+            | Some {server = true; _} -> HashtblJournal.transaction (Slvr.solve entrystates entrystates_global startvars')
+            | _ -> Slvr.solve entrystates entrystates_global startvars'
+          in
+          let (lh, gh), solver_data = Timing.wrap "solving" (Sampling.wrap_phase "solving" solve) solver_data in
+          Summaries.finalize (fun f -> LHT.iter f lh);
+          if HeapBreakdown.enabled () then
+            Timing.wrap "heap breakdown" (heap_breakdown gh (fun f -> LHT.iter f lh) (fun f -> GHT.iter f gh)) [("lh", Obj.repr lh); ("gh", Obj.repr gh); ("data", Obj.repr solver_data)];
           if GobConfig.get_bool "incremental.save" then
             Serialize.Cache.(update_data SolverData solver_data);
           if save_run_str <> "" then (
@@ -760,7 +827,12 @@ struct
       | `Right _ -> (* contexts global *)
         ()
     in
-    Timing.wrap "warn_global" (GHT.iter warn_global) gh;
+    let warn_globals gh =
+      let globals = GHT.fold (fun g v acc -> (g, v) :: acc) gh [] |> List.rev in (* same order as GHT.iter *)
+      ForkPool.iter ~jobs:(jobs ()) (fun (g, v) -> warn_global g v) globals
+    in
+    Timing.wrap "warn_global" (Sampling.wrap_phase "warn_global" warn_globals) gh;
+    Sampling.stop ();
 
     if get_bool "exp.arg.enabled" then (
       let module ArgTool = ArgTools.Make (R) in
@@ -838,7 +910,9 @@ let rec analyze_loop (module CFG : CfgBidirSkip) file fs change_info =
   try
     let (module Spec) = get_spec () in
     let module A = AnalyzeCFG (CFG) (Spec) (struct let increment = change_info end) in
-    GobConfig.with_immutable_conf (fun () -> A.analyze file fs)
+    GobConfig.with_immutable_conf (fun () ->
+        Fun.protect ~finally:Sampling.stop (fun () -> A.analyze file fs) (* also stop if analysis raises, e.g. on timeout *)
+      )
   with Refinement.RestartAnalysis ->
     (* Tail-recursively restart the analysis again, when requested.
         All solving starts from scratch.
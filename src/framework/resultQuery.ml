@@ -44,7 +44,8 @@ struct
     in
     Spec.query man
 
-  let ask_global (gh: EQSys.G.t GHT.t) =
+  (** Like {!ask_global}, but with given values of globals. *)
+  let ask_global_with (global: EQSys.GVar.t -> EQSys.G.t) =
     (* copied from Control for WarnGlobal *)
     (* build a man for using the query system *)
     let rec man =
@@ -56,13 +57,16 @@ struct
       ; context = (fun () -> man_failwith "No context in query context.")
       ; edge    = MyCFG.Skip
       ; local  = Spec.startstate GoblintCil.dummyFunDec.svar (* bot and top both silently raise and catch Deadcode in DeadcodeLifter *) (* TODO: is this startstate bad? *)
-      ; global = (fun v -> EQSys.G.spec (try GHT.find gh (EQSys.GVar.spec v) with Not_found -> EQSys.G.bot ())) (* TODO: how can be missing? *)
+      ; global = (fun v -> EQSys.G.spec (global (EQSys.GVar.spec v)))
       ; spawn  = (fun ?(multiple=false) v d   -> failwith "Cannot \"spawn\" in query context.")
       ; split  = (fun d es   -> failwith "Cannot \"split\" in query context.")
       ; sideg  = (fun v g    -> failwith "Cannot \"split\" in query context.")
       }
     in
     Spec.query man
+
+  let ask_global (gh: EQSys.G.t GHT.t) =
+    ask_global_with (fun v -> try GHT.find gh v with Not_found -> EQSys.G.bot ()) (* TODO: how can be missing? *)
 end
 
 
@@ -0,0 +1,302 @@
+(** Per-function summaries, which are exported from one run and imported into another instead of solving those functions.
+
+    A summary of a function in a context consists of its return state together with
+    the interprocedural local unknowns (entry state, callee returns) and globals it reads,
+    and the local (callee and thread entries) and global side effects it causes.
+    An imported summary is used if the function's fingerprint, the names of globals and callees it references and the analysis options match,
+    and the current values of the read unknowns are still subsumed by the recorded ones.
+    Otherwise the function is solved as usual.
+
+    Abstract values contain variable and statement ids, so the exporting run's CIL file is exported as well
+    and unchanged globals of the importing run get their old ids, like with [incremental.load] (see {!rename}).
+
+    Reusing a summary replaces the right-hand side of the function's return unknown, so its other nodes aren't evaluated:
+    messages emitted by them during the exporting run are stored with the summary and replayed instead.
+    Messages are recorded before their deduplication, so one emitted in multiple contexts is stored with each of their summaries.
+
+    Importing summaries is incompatible with [incremental.load], whose ids the summaries' abstract values don't agree with. *)
+
+open Batteries
+open GoblintCil
+open MyCFG
+open Analyses
+open ConstrSys
+
+(** Marshaled summaries. *)
+type 'functions data = {
+  options: Digest.t;
+  cil_file: file; (** File of the exporting run, to preserve ids of unchanged globals. *)
+  max_ids: MaxIdUtil.max_ids;
+  functions: 'functions;
+}
+
+(** Summaries loaded by {!rename}, before the functor's types are known. *)
+let loaded: Obj.t option ref = ref None
+
+let unmarshal filename =
+  match !loaded with
+  | Some data -> Obj.obj data
+  | None -> Serialize.unmarshal (Fpath.v filename)
+
+(** Give globals of [current_file], which are unchanged since the run exporting [incremental.summaries.load], their old ids,
+    such that the abstract values of their summaries apply.
+    Must be called before the CFG is computed. *)
+let rename current_file =
+  let filename = GobConfig.get_string "incremental.summaries.load" in
+  if filename <> "" then (
+    let data: Obj.t data = Serialize.unmarshal (Fpath.v filename) in
+    loaded := Some (Obj.repr data);
+    let changes = CompareCIL.compareCilFiles data.cil_file current_file in
+    ignore (UpdateCil.update_ids data.cil_file data.max_ids current_file changes)
+  )
+
+module Make (S: Spec) (System: GlobConstrSys with module LVar = VarF (S.C)
+                                              and module GVar = GVarF (S.V)
+                                              and module D = S.D
+                                              and module G = GVarG (S.G) (S.C)) =
+struct
+  module LH = BatHashtbl.Make (System.LVar)
+  module GH = BatHashtbl.Make (System.GVar)
+
+  type summary = {
+    local_reads: (System.LVar.t * S.D.t) list;
+    global_reads: (System.GVar.t * System.G.t) list;
+    local_sides: (System.LVar.t * S.D.t) list;
+    global_sides: (System.GVar.t * System.G.t) list;
+    return: S.D.t;
+    messages: Messages.Message.t list; (** Messages from all nodes of the function in the context. *)
+  }
+
+  (** Identification of a function, which must match for its summaries to be imported. *)
+  type key = {
+    fingerprint: FingerprintCIL.fingerprint; (** Structural, i.e. independent of ids. *)
+    globals: string list; (** Names of globals and callees referenced in the function. *)
+  }
+
+  type t = (string, key * (S.C.t * summary) list) Hashtbl.t data
+
+  let options_digest () =
+    ["ana"; "sem"; "exp"]
+    |> List.map (fun o -> Yojson.Safe.to_string (GobConfig.get_json o))
+    |> String.concat ","
+    |> Digest.string
+
+  class globalsVisitor globals = object
+    inherit nopCilVisitor
+    method! vvrbl v =
+      if v.vglob then
+        globals := v.vname :: !globals;
+      SkipChildren
+  end
+
+  let key (fd: fundec): key =
+    let globals = ref [] in
+    ignore (visitCilFunction (new globalsVisitor globals) fd);
+    {
+      fingerprint = FingerprintCIL.fundec fd;
+      globals = List.sort_uniq String.compare !globals;
+    }
+
+  let key_equal (k1: key) (k2: key) =
+    FingerprintCIL.equal k1.fingerprint k2.fingerprint && List.equal String.equal k1.globals k2.globals
+
+  let is_interprocedural ((n, _): System.LVar.t) =
+    match n with
+    | Function _
+    | FunctionEntry _ -> true
+    | Statement _ -> false
+
+  let save = ref false
+
+  (** Unknowns read and side-effected from nodes of a function in a context during solving. *)
+  type record = {
+    r_local_reads: S.D.t LH.t;
+    r_global_reads: System.G.t GH.t;
+    r_local_sides: S.D.t LH.t;
+    r_global_sides: System.G.t GH.t;
+    r_messages: unit Messages.Table.MH.t;
+  }
+
+  module FC = Printable.Prod (CilType.Fundec) (S.C)
+  module FCH = BatHashtbl.Make (FC)
+
+  let records: record FCH.t = FCH.create 113
+
+  (** Imported summaries by return unknown. *)
+  let imported: summary LH.t = LH.create 113
+
+  (** Imported summaries, which were used by the last evaluation of their return unknown. *)
+  let reused: summary FCH.t = FCH.create 113
+
+  let hits = ref 0
+  let misses = ref 0
+
+  let record_tf ((n, c): System.LVar.t) tf getl sidel getg sideg =
+    let fd = Node.find_fundec n in
+    let r = FCH.find_option records (fd, c) |> Option.default_delayed (fun () ->
+        let r = {r_local_reads = LH.create 7; r_global_reads = GH.create 7; r_local_sides = LH.create 7; r_global_sides = GH.create 7; r_messages = Messages.Table.MH.create 7} in
+        FCH.replace records (fd, c) r;
+        r
+      )
+    in
+    (* Reads are replaced because the last evaluation (by the postsolver) sees the final values. *)
+    let getl y =
+      let d = getl y in
+      if is_interprocedural y then
+        LH.replace r.r_local_reads y d;
+      d
+    in
+    let sidel y d =
+      LH.modify_def (S.D.bot ()) y (S.D.join d) r.r_local_sides;
+      sidel y d
+    in
+    let getg g =
+      let d = getg g in
+      GH.replace r.r_global_reads g d;
+      d
+    in
+    let sideg g d =
+      GH.modify_def (System.G.bot ()) g (System.G.join d) r.r_global_sides;
+      sideg g d
+    in
+    if !AnalysisState.should_warn then (
+      let hook = !Messages.emit_hook in
+      Messages.emit_hook := (fun m ->
+          Messages.Table.MH.replace r.r_messages m ();
+          hook m
+        );
+      Fun.protect ~finally:(fun () -> Messages.emit_hook := hook) (fun () ->
+          tf getl sidel getg sideg
+        )
+    )
+    else
+      tf getl sidel getg sideg
+
+  let import_tf fd c s tf getl sidel getg sideg =
+    let (entry_reads, return_reads) = List.partition (function ((FunctionEntry _, _), _) -> true | _ -> false) s.local_reads in
+    let use =
+      List.for_all (fun (y, d) -> S.D.leq (getl y) d) entry_reads &&
+      List.for_all (fun (g, d) -> System.G.leq (getg g) d) s.global_reads && (
+        (* Same order as thread creation and function calls: side-effect to entry, then read return.
+           Returns of callees can only be checked after their entries, so a summary rejected by them leaves its entry side effects.
+           These are sound, but may cause callee contexts, which solving the function doesn't need. *)
+        List.iter (fun (y, d) -> sidel y d) s.local_sides;
+        List.for_all (fun (y, d) -> S.D.leq (getl y) d) return_reads
+      )
+    in
+    if use then (
+      incr hits;
+      FCH.replace reused (fd, c) s;
+      List.iter (fun (g, d) -> sideg g d) s.global_sides;
+      if !AnalysisState.should_warn then
+        List.iter Messages.add s.messages;
+      s.return
+    )
+    else (
+      incr misses;
+      FCH.remove reused (fd, c);
+      tf getl sidel getg sideg
+    )
+
+  module EQSys: GlobConstrSys with module LVar = VarF (S.C)
+                               and module GVar = GVarF (S.V)
+                               and module D = S.D
+                               and module G = GVarG (S.G) (S.C) =
+  struct
+    include System
+
+    let system ((n, c) as v) =
+      match System.system v with
+      | None -> None
+      | Some tf ->
+        let tf = if !save then record_tf v tf else tf in
+        match n with
+        | Function fd when LH.mem imported v ->
+          Some (import_tf fd c (LH.find imported v) tf)
+        | _ ->
+          Some tf
+  end
+
+  let relift_summary s = {
+    local_reads = List.map (Tuple2.map System.LVar.relift S.D.relift) s.local_reads;
+    global_reads = List.map (Tuple2.map System.GVar.relift System.G.relift) s.global_reads;
+    local_sides = List.map (Tuple2.map System.LVar.relift S.D.relift) s.local_sides;
+    global_sides = List.map (Tuple2.map System.GVar.relift System.G.relift) s.global_sides;
+    return = S.D.relift s.return;
+    messages = s.messages;
+  }
+
+  let load filename =
+    let {options; functions; _}: t = unmarshal filename in
+    if not (Digest.equal options (options_digest ())) then
+      Logs.warn "Ignoring summaries from %s, which were computed with different analysis options" filename
+    else (
+      let functions_imported = ref 0 in
+      Hashtbl.iter (fun name (k, summaries) ->
+          match Cilfacade.find_name_fundec name with
+          | fd when key_equal k (key fd) ->
+            incr functions_imported;
+            List.iter (fun (c, s) ->
+                LH.replace imported (Function fd, S.C.relift c) (relift_summary s)
+              ) summaries
+          | _ -> ()
+          | exception Not_found -> ()
+        ) functions;
+      Logs.info "Imported summaries of %d of %d functions from %s" !functions_imported (Hashtbl.length functions) filename
+    )
+
+  let init () =
+    FCH.clear records;
+    FCH.clear reused;
+    LH.clear imported;
+    hits := 0;
+    misses := 0;
+    save := GobConfig.get_string "incremental.summaries.save" <> "";
+    let filename = GobConfig.get_string "incremental.summaries.load" in
+    if filename <> "" && not (GobConfig.get_bool "incremental.load") then (* server mode enables incremental.load after the first analysis, whose results already include the summaries *)
+      Timing.wrap "summaries load" load filename
+
+  let export filename (iter_lh: (System.LVar.t -> S.D.t -> unit) -> unit) =
+    let functions = Hashtbl.create 113 in
+    let contexts = ref 0 in
+    let add (fd: fundec) c s =
+      incr contexts;
+      Hashtbl.modify_opt fd.svar.vname (function
+          | None -> Some (key fd, [(c, s)])
+          | Some (k, summaries) -> Some (k, (c, s) :: summaries)
+        ) functions
+    in
+    iter_lh (fun (n, c) d ->
+        match n with
+        | Function fd ->
+          begin match FCH.find_option reused (fd, c), FCH.find_option records (fd, c) with
+            | Some s, _ ->
+              add fd c s
+            | None, Some r ->
+              add fd c {
+                local_reads = LH.to_list r.r_local_reads;
+                global_reads = GH.to_list r.r_global_reads;
+                local_sides = LH.to_list r.r_local_sides;
+                global_sides = GH.to_list r.r_global_sides;
+                return = d;
+                messages = List.of_seq (Messages.Table.MH.to_seq_keys r.r_messages);
+              }
+            | None, None -> ()
+          end
+        | _ -> ()
+      );
+    let cil_file = !Cilfacade.current_file in
+    let data: t = {options = options_digest (); cil_file; max_ids = MaxIdUtil.get_file_max_ids cil_file; functions} in
+    Serialize.marshal data (Fpath.v filename);
+    Logs.info "Exported summaries of %d functions in %d contexts to %s" (Hashtbl.length functions) !contexts filename
+
+  let finalize iter_lh =
+    if !hits > 0 || !misses > 0 then
+      Logs.info "Summaries: %d uses, %d fallbacks to solving" !hits !misses;
+    if !save then
+      Timing.wrap "summaries export" (export (GobConfig.get_string "incremental.summaries.save")) iter_lh;
+    FCH.clear records;
+    FCH.clear reused;
+    LH.clear imported;
+    loaded := None
+end
@@ -50,6 +50,7 @@ let main () =
     )
     else (
       let file = Lazy.force file in
+      Summaries.rename file;
       let changeInfo =
         if GobConfig.get_bool "incremental.load" || GobConfig.get_bool "incremental.save" then
           diff_and_rename file
@@ -22,6 +22,7 @@ module CfgTools = CfgTools
 
 module Analyses = Analyses
 module ConstrSys = ConstrSys
+module HashtblJournal = HashtblJournal
 module Constraints = Constraints
 module CompareConstraints = CompareConstraints
 module AnalysisState = AnalysisState
@@ -79,6 +80,7 @@ module RelationAnalysis = RelationAnalysis
 module ApronAnalysis = ApronAnalysis
 module AffineEqualityAnalysis = AffineEqualityAnalysis
 module LinearTwoVarEqualityAnalysis = LinearTwoVarEqualityAnalysis
+module OctagonAnalysis = OctagonAnalysis
 module VarEq = VarEq
 module CondVars = CondVars
 module TmpSpecial = TmpSpecial
@@ -261,6 +263,7 @@ module RelationDomain = RelationDomain
 module ApronDomain = ApronDomain
 module AffineEqualityDomain = AffineEqualityDomain
 module LinearTwoVarEqualityDomain = LinearTwoVarEqualityDomain
+module OctagonDomain = OctagonDomain
 
 (** {3 Concurrency} *)
 
@@ -307,6 +310,7 @@ module CompareCFG = CompareCFG
 module UpdateCil = UpdateCil
 module MaxIdUtil = MaxIdUtil
 module Serialize = Serialize
+module Summaries = Summaries
 module CilMaps = CilMaps
 
 
@@ -322,6 +326,7 @@ module Logs = Logs
     The following modules handle program input. *)
 
 module Preprocessor = Preprocessor
+module PreprocessCache = PreprocessCache
 module CompilationDatabase = CompilationDatabase
 module MakefileUtil = MakefileUtil
 module TerminationPreprocessing = TerminationPreprocessing
@@ -384,6 +389,7 @@ module ExpressionEvaluation = ExpressionEvaluation
 (** {1 Utilities} *)
 
 module Timing = Timing
+module HeapBreakdown = HeapBreakdown
 module GoblintDir = GoblintDir
 
 (** {2 General} *)
@@ -395,6 +401,7 @@ module LazyEval = LazyEval
 module ResettableLazy = ResettableLazy
 
 module ProcessPool = ProcessPool
+module ForkPool = ForkPool
 module Timeout = Timeout
 
 module TimeUtil = TimeUtil
@@ -85,6 +85,9 @@ let empty_rename_mapping: rename_mapping = (StringMap.empty, VarinfoMap.empty, V
 let should_reanalyze (fdec: Cil.fundec) =
   List.mem fdec.svar.vname (GobConfig.get_string_list "incremental.force-reanalyze.funs")
 
+let should_demand (fdec: Cil.fundec) =
+  List.mem fdec.svar.vname (GobConfig.get_string_list "incremental.demand.funs")
+
 let performRenames (renamesOnSuccess: renamesOnSuccess) =
   begin
     let (compinfoRenames, enumRenames) = renamesOnSuccess in
@@ -141,6 +144,8 @@ let eqF (old: Cil.fundec) (current: Cil.fundec) (cfgs : (cfg * (cfg * cfg)) opti
   let identical, diffOpt, (_, renamed_method_dependencies, renamed_global_vars_dependencies, renamesOnSuccess) =
     if should_reanalyze current then
       ForceReanalyze current, None, empty_rename_mapping
+    else if should_demand current then
+      Changed, None, empty_rename_mapping
     else
 
       let add_locals_to_rename_mapping la lb map =
@@ -253,9 +258,47 @@ let eqF_check_contained_renames ~renameDetection f1 f2 oldMap newMap cfgs gc_old
      append_to_changed ~unchangedHeader:false ~diff:None);
   change_info, addToFinalMatchesMapping f1.svar f2.svar final_matches
 
+(** Old and new function fingerprints of the current comparison, if enabled. *)
+let fingerprints: (FingerprintCIL.t * FingerprintCIL.t) option ref = ref None
+let fingerprint_matches = ref 0
+
+let fingerprint_unchanged (f1: fundec) (f2: fundec) oldMap newMap =
+  match !fingerprints with
+  | Some (old_fps, new_fps) when not (should_reanalyze f2 || should_demand f2) ->
+    begin match Hashtbl.find_opt old_fps f1.svar.vname, Hashtbl.find_opt new_fps f2.svar.vname with
+      | Some fp1, Some (fp2: FingerprintCIL.fingerprint) ->
+        FingerprintCIL.equal fp1 fp2 && List.for_all (fun name -> GlobalMap.mem name oldMap && GlobalMap.mem name newMap) fp2.globals
+      | _, _ -> false
+    end
+  | _ -> false
+
+(* Same result as [eqF_check_contained_renames] for functions with equal fingerprints, without comparing their bodies. *)
+let eqF_fingerprint ~renameDetection f1 f2 oldMap newMap gc_old gc_new (change_info, final_matches) =
+  incr fingerprint_matches;
+  let dependenciesMatch, change_info, final_matches =
+    if renameDetection then
+      let (fp: FingerprintCIL.fingerprint) = Hashtbl.find (snd (Option.get !fingerprints)) f2.svar.vname in
+      List.fold_left (fun (acc, ci, fm) name ->
+          let glob_old = GlobalMap.find name oldMap in
+          let glob_new = GlobalMap.find name newMap in
+          if acc then
+            compare_varinfo_exact (get_varinfo glob_old) glob_old oldMap (get_varinfo glob_new) glob_new newMap ci fm
+          else false, ci, fm
+        ) (true, change_info, final_matches) fp.globals
+    else
+      true, change_info, final_matches
+  in
+  if dependenciesMatch then
+    change_info.unchanged <- {old = gc_old; current = gc_new} :: change_info.unchanged
+  else
+    change_info.changed <- {current = gc_new; old = gc_old; unchangedHeader = true; diff = None} :: change_info.changed;
+  change_info, addToFinalMatchesMapping f1.svar f2.svar final_matches
+
 let eq_glob ?(matchVars=true) ?(matchFuns=true) ?(renameDetection=false) oldMap newMap cfgs gc_old gc_new (change_info, final_matches) =
   match gc_old.def, gc_new.def with
   | Some (Var v1), Some (Var v2) when matchVars -> let _, ci, fm = eq_glob_var v1 gc_old oldMap v2 gc_new newMap change_info final_matches in ci, fm
+  | Some (Fun f1), Some (Fun f2) when matchFuns && fingerprint_unchanged f1 f2 oldMap newMap ->
+    eqF_fingerprint ~renameDetection f1 f2 oldMap newMap gc_old gc_new (change_info, final_matches)
   | Some (Fun f1), Some (Fun f2) when matchFuns ->
     eqF_check_contained_renames ~renameDetection f1 f2 oldMap newMap cfgs gc_old gc_new (change_info, final_matches)
   | None, None -> (match gc_old.decls, gc_new.decls with
@@ -286,7 +329,7 @@ let addOldGlobals name gc_old (change_info, final_matches) =
     change_info.removed <- gc_old :: change_info.removed;
   (change_info, final_matches)
 
-let compareCilFiles ?(eq=eq_glob) (oldAST: file) (newAST: file) =
+let compareCilFiles ?(eq=eq_glob) ?old_fingerprints (oldAST: file) (newAST: file) =
   let cfgs = if GobConfig.get_string "incremental.compare" = "cfg"
     then Some Batteries.(CfgTools.getCFG oldAST |> Tuple3.first, CfgTools.getCFG newAST |> Tuple3.get12)
     else None in
@@ -317,6 +360,17 @@ let compareCilFiles ?(eq=eq_glob) (oldAST: file) (newAST: file) =
 
   let changes = empty_change_info () in
   global_typ_acc := [];
+  fingerprint_matches := 0;
+  fingerprints :=
+    if GobConfig.get_bool "incremental.fingerprint" then (
+      let old_fingerprints = match old_fingerprints with
+        | Some old_fingerprints -> old_fingerprints
+        | None -> FingerprintCIL.file oldAST
+      in
+      Some (old_fingerprints, FingerprintCIL.file newAST)
+    )
+    else
+      None;
 
   let findChanges ?(matchVars=true) ?(matchFuns=true) ?(renameDetection=false) oldMap newMap cfgs name gc_new (change_info, final_matches) =
     try
@@ -343,9 +397,12 @@ let compareCilFiles ?(eq=eq_glob) (oldAST: file) (newAST: file) =
       |> GlobalMap.fold addOldGlobals oldMap in
     ()
   );
+  if Option.is_some !fingerprints then
+    Logs.debug "%d functions unchanged by fingerprint" !fingerprint_matches;
+  fingerprints := None;
   changes
 
 (** Given an (optional) equality function between [Cil.global]s, an old and a new [Cil.file], this function computes a [change_info],
     which describes which [global]s are changed, unchanged, removed and added.  *)
-let compareCilFiles ?eq (oldAST: file) (newAST: file) =
-  Timing.wrap "compareCilFiles" (compareCilFiles ?eq oldAST) newAST
+let compareCilFiles ?eq ?old_fingerprints (oldAST: file) (newAST: file) =
+  Timing.wrap "compareCilFiles" (compareCilFiles ?eq ?old_fingerprints oldAST) newAST
@@ -0,0 +1,219 @@
+(** Structural fingerprints of CIL functions for fast incremental change detection.
+
+    Functions with equal fingerprints are considered unchanged by {!CompareCIL} without the structural comparison.
+    Fingerprints ignore locations, vids, sids and names of locals.
+    Goto targets are identified by their position in the function instead of by sid. *)
+
+open GoblintCil
+
+type fingerprint = {
+  digest: Digest.t;
+  comparable: bool; (** [false] if the function contains constructs which the structural comparison never considers equal. *)
+  globals: string list; (** Non-function globals used in the function, which the rename detection checks as dependencies. *)
+}
+
+(** Fingerprints of function definitions by name. *)
+type t = (string, fingerprint) Hashtbl.t
+
+let fundec (fd: fundec): fingerprint =
+  let buf = Buffer.create 1024 in
+  let comparable = ref true in
+  let tag c = Buffer.add_char buf c in
+  let string s =
+    Buffer.add_string buf (string_of_int (String.length s));
+    tag ':';
+    Buffer.add_string buf s
+  in
+  let int i = string (string_of_int i) in
+  let bool b = tag (if b then 't' else 'f') in
+  let leaf x = string (Marshal.to_string x []) in (* constant constructors and floats *)
+  let list f xs = int (List.length xs); List.iter f xs in
+  let option f = function
+    | None -> tag 'n'
+    | Some x -> tag 's'; f x
+  in
+
+  let locals = Hashtbl.create 17 in
+  List.iteri (fun i (v: varinfo) -> Hashtbl.replace locals v.vid i) (fd.sformals @ fd.slocals);
+  let stmts = Hashtbl.create 17 in
+  List.iteri (fun i (s: stmt) -> Hashtbl.replace stmts s.sid i) fd.sallstmts;
+  let comps = Hashtbl.create 7 in
+  let globals = Hashtbl.create 17 in
+  let global_vars = ref [] in
+
+  let rec typ = function
+    | TVoid a -> tag 'v'; attributes a
+    | TInt (ik, a) -> tag 'i'; leaf ik; attributes a
+    | TFloat (fk, a) -> tag 'f'; leaf fk; attributes a
+    | TPtr (t, a) -> tag 'p'; typ t; attributes a
+    | TArray (t, len, a) -> tag 'a'; typ t; option exp len; attributes a
+    | TFun (t, args, va, a) ->
+      tag 'F';
+      typ t;
+      option (list (fun (n, t, a) -> string n; typ t; attributes a)) args;
+      bool va;
+      attributes a
+    | TNamed (ti, a) -> tag 'N'; string ti.tname; typ ti.ttype; attributes a
+    | TComp (ci, a) -> tag 'C'; compinfo ci; attributes a
+    | TEnum (ei, a) ->
+      tag 'E';
+      string ei.ename;
+      attributes ei.eattr;
+      list (fun (n, a, e, _) -> string n; attributes a; exp e) ei.eitems;
+      attributes a
+    | TBuiltin_va_list a -> tag 'V'; attributes a
+  and compinfo ci =
+    bool ci.cstruct;
+    string ci.cname;
+    (* recursive types: fields only on first occurrence *)
+    if not (Hashtbl.mem comps ci.ckey) then (
+      Hashtbl.replace comps ci.ckey ();
+      list fieldinfo ci.cfields;
+      attributes ci.cattr;
+      bool ci.cdefined
+    )
+  and fieldinfo fi =
+    string fi.fname;
+    typ fi.ftype;
+    option int fi.fbitfield;
+    attributes fi.fattr
+  and attributes a =
+    list (fun (Attr (n, ps)) -> string n; list attrparam ps) a
+  and attrparam = function
+    | AInt i -> tag '0'; int i
+    | AStr s -> tag '1'; string s
+    | ACons (s, ps) -> tag '2'; string s; list attrparam ps
+    | ASizeOf t -> tag '3'; typ t
+    | ASizeOfE p -> tag '4'; attrparam p
+    | ASizeOfS ts -> tag '5'; string (CilType.Typsig.show ts)
+    | AAlignOf t -> tag '6'; typ t
+    | AAlignOfE p -> tag '7'; attrparam p
+    | AAlignOfS ts -> tag '8'; string (CilType.Typsig.show ts)
+    | AUnOp (op, p) -> tag '9'; leaf op; attrparam p
+    | ABinOp (op, p1, p2) -> tag 'b'; leaf op; attrparam p1; attrparam p2
+    | ADot (p, s) -> tag 'd'; attrparam p; string s
+    | AStar p -> tag '*'; attrparam p
+    | AAddrOf p -> tag '&'; attrparam p
+    | AIndex (p1, p2) -> tag '['; attrparam p1; attrparam p2
+    | AQuestion (p1, p2, p3) -> tag '?'; attrparam p1; attrparam p2; attrparam p3
+    | AAssign (p1, p2) -> tag '='; attrparam p1; attrparam p2
+  and constant = function
+    | CInt (i, ik, _) -> tag 'i'; string (Z.to_string i); leaf ik (* ignore string representation, like CompareAST *)
+    | CStr (s, enc) -> tag 's'; string s; leaf enc
+    | CWStr (cs, wt) -> tag 'w'; list (fun c -> string (Int64.to_string c)) cs; leaf wt
+    | CChr c -> tag 'c'; string (String.make 1 c)
+    | CReal (f, fk, s) -> tag 'r'; leaf f; leaf fk; option string s
+    | CEnum (e, _, _) -> tag 'e'; exp e (* ignore name and enuminfo, like CompareAST *)
+  and exp = function
+    | Const c -> tag 'c'; constant c
+    | Lval lv -> tag 'l'; lval lv
+    | SizeOf t -> tag 's'; typ t
+    | SizeOfE e -> tag 'S'; exp e
+    | SizeOfStr s -> tag 't'; string s
+    | AlignOf t -> tag 'a'; typ t
+    | AlignOfE e -> tag 'A'; exp e
+    | UnOp (op, e, t) -> tag 'u'; leaf op; exp e; typ t
+    | BinOp (op, e1, e2, t) -> tag 'b'; leaf op; exp e1; exp e2; typ t
+    | Question (e1, e2, e3, t) -> tag '?'; exp e1; exp e2; exp e3; typ t
+    | CastE (t, e) -> tag 'C'; typ t; exp e
+    | AddrOf lv -> tag '&'; lval lv
+    | AddrOfLabel _ -> comparable := false
+    | StartOf lv -> tag '@'; lval lv
+    | Real e -> tag 'r'; exp e
+    | Imag e -> tag 'i'; exp e
+  and lval (lh, off) =
+    begin match lh with
+      | Var v -> tag 'v'; varinfo v
+      | Mem e -> tag 'm'; exp e
+    end;
+    offset off
+  and offset = function
+    | NoOffset -> tag 'n'
+    | Field (fi, off) -> tag 'f'; fieldinfo fi; offset off
+    | Index (e, off) -> tag 'i'; exp e; offset off
+  and varinfo (v: varinfo) =
+    if v.vglob then (
+      tag 'g';
+      string v.vname;
+      if not (Hashtbl.mem globals v.vname) then (
+        Hashtbl.replace globals v.vname ();
+        begin match v.vtype with
+          | TFun _ -> ()
+          | _ -> global_vars := v.vname :: !global_vars
+        end;
+        varinfo_decl v
+      )
+    )
+    else (
+      match Hashtbl.find_opt locals v.vid with
+      | Some i -> tag 'l'; int i
+      | None -> comparable := false
+    )
+  and varinfo_decl (v: varinfo) =
+    typ v.vtype;
+    attributes v.vattr;
+    leaf v.vstorage;
+    bool v.vglob;
+    bool v.vaddrof
+  in
+
+  let label = function
+    | Label (n, _, b) -> tag 'L'; string n; bool b
+    | Case (e, _, _) -> tag 'C'; exp e
+    | CaseRange _ -> comparable := false
+    | Default _ -> tag 'D'
+  in
+  let stmt_position (s: stmt) =
+    match Hashtbl.find_opt stmts s.sid with
+    | Some i -> int i
+    | None -> comparable := false
+  in
+  let instr = function
+    | Set (lv, e, _, _) -> tag 's'; lval lv; exp e
+    | VarDecl (v, _) -> tag 'd'; varinfo v
+    | Call (lv, f, args, _, _) -> tag 'c'; option lval lv; exp f; list exp args
+    | Asm (_, tmpls, outs, ins, clobs, _) -> (* ignore attributes, like CompareAST *)
+      tag 'a';
+      list string tmpls;
+      list (fun (n, c, lv) -> option string n; string c; lval lv) outs;
+      list (fun (n, c, e) -> option string n; string c; exp e) ins;
+      list string clobs
+  in
+  let rec stmt (s: stmt) =
+    list label s.labels;
+    match s.skind with
+    | Instr is -> tag 'I'; list instr is
+    | Return (e, _, _) -> tag 'R'; option exp e
+    | Goto (target, _) -> tag 'G'; list label (!target).labels; stmt_position !target
+    | ComputedGoto _ -> comparable := false
+    | Break _ -> tag 'B'
+    | Continue _ -> tag 'K'
+    | If (e, b1, b2, _, _) -> tag '?'; exp e; block b1; block b2
+    | Switch (e, b, cases, _, _) -> tag 'S'; exp e; block b; list stmt_position cases
+    | Loop (b, _, _, _, _) -> tag 'W'; block b
+    | Block b -> tag '{'; block b
+  and block b =
+    attributes b.battrs;
+    list stmt b.bstmts
+  in
+
+  tag 'g';
+  string fd.svar.vname;
+  varinfo_decl fd.svar;
+  list varinfo_decl fd.sformals;
+  list varinfo_decl fd.slocals;
+  block fd.sbody;
+  {digest = Digest.string (Buffer.contents buf); comparable = !comparable; globals = !global_vars}
+
+let file (file: file): t =
+  let fingerprints = Hashtbl.create 113 in
+  Cil.iterGlobals file (function
+      | GFun (fd, _) -> Hashtbl.replace fingerprints fd.svar.vname (fundec fd)
+      | _ -> ()
+    );
+  fingerprints
+
+let file = Timing.wrap "fingerprint" file
+
+let equal (fp1: fingerprint) (fp2: fingerprint) =
+  fp1.comparable && fp2.comparable && Digest.equal fp1.digest fp2.digest
@@ -43,6 +43,7 @@ module Cache = struct
     mutable analysis_data: Obj.t option;
     mutable version_data: MaxIdUtil.max_ids option;
     mutable cil_file: GoblintCil.file option;
+    mutable fingerprints: FingerprintCIL.t option;
   }
 
   let data = ref {
@@ -50,6 +51,7 @@ module Cache = struct
       analysis_data = None;
       version_data = None;
       cil_file = None;
+      fingerprints = None;
     }
 
   (** GADT that may be used to query data from and pass data to the cache. *)
@@ -58,6 +60,7 @@ module Cache = struct
     | CilFile : GoblintCil.file data_query
     | VersionData : MaxIdUtil.max_ids data_query
     | AnalysisData : _ data_query
+    | Fingerprints : FingerprintCIL.t data_query (** Fingerprints of functions in [CilFile]. *)
 
   (** Loads data for incremental runs from the appropriate file *)
   let load_data () =
@@ -79,6 +82,7 @@ module Cache = struct
     | AnalysisData -> !data.analysis_data <- Some (Obj.repr d)
     | VersionData -> !data.version_data <- Some d
     | CilFile -> !data.cil_file <- Some d
+    | Fingerprints -> !data.fingerprints <- Some d
 
   (** Reset some incremental data in the in-memory cache to [None]*)
   let reset_data : type a. a data_query -> unit = function
@@ -86,6 +90,7 @@ module Cache = struct
     | AnalysisData -> !data.analysis_data <- None
     | VersionData -> !data.version_data <- None
     | CilFile -> !data.cil_file <- None
+    | Fingerprints -> !data.fingerprints <- None
 
   (** Get incremental data from the in-memory cache wrapped in an optional.
       To populate the in-memory cache with data, call [load_data] first. *)
@@ -94,6 +99,7 @@ module Cache = struct
     | AnalysisData -> Option.map Obj.obj !data.analysis_data
     | VersionData -> !data.version_data
     | CilFile -> !data.cil_file
+    | Fingerprints -> !data.fingerprints
 
   (** Get incremental data from the in-memory cache.
       Same as [get_opt_data], except not yielding an optional and failing when the requested data is not present. *)
@@ -58,6 +58,14 @@ struct
         | _ ->
           Queries.Result.top q
       end
+    | IterGlobalComponents (g, f) ->
+      let g: V.t = Obj.obj g in
+      begin match g with
+        | `Left g' ->
+          S.query (conv man) (IterGlobalComponents (Obj.repr g', f))
+        | _ ->
+          f "longjmp.G" (Obj.repr (man.global g))
+      end
     | InvariantGlobal g ->
       let g: V.t = Obj.obj g in
       begin match g with
@@ -98,6 +98,14 @@ struct
           S.query (conv man) (WarnGlobal (Obj.repr v'))
         | `Right call -> cycleDetection man call (* Note: to make it more efficient, one could only execute the cycle detection in case the loop analysis returns true, because otherwise the program will probably not terminate anyway*)
       end
+    | IterGlobalComponents (v, f) ->
+      let v: V.t = Obj.obj v in
+      begin match v with
+        | `Left v' ->
+          S.query (conv man) (IterGlobalComponents (Obj.repr v', f))
+        | `Right _ ->
+          f "recursionTerm.G" (Obj.repr (man.global v))
+      end
     | InvariantGlobal v ->
       let v: V.t = Obj.obj v in
       begin match v with
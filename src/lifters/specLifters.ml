@@ -17,6 +17,7 @@ struct
     (* We do refine int values on narrow and meet {!IntDomain.IntDomTupleImpl}, which can lead to fixpoint issues if we assume x op x = x *)
     (* see https://github.com/goblint/analyzer/issues/1005 *)
     let assume_idempotent = GobConfig.get_string "ana.int.refinement" = "never"
+    let memo_size = GobConfig.get_int "ana.opt.hashcons-memo"
   end
   module D = Lattice.HConsed (S.D) (HConsedArg)
   module G = S.G
@@ -536,9 +537,43 @@ struct
 
   let name () = "PathSensitive2("^Spec.name ()^")"
 
+  let path_limit = GobConfig.get_int "ana.path_sens_limit"
+  let max_paths = ref 0
+  let merges = ref 0
+  let merged_paths = ref 0
+
+  (** Merge excess paths if there are more than [ana.path_sens_limit]:
+      the first [ana.path_sens_limit - 1] paths are kept, and the others are dropped if one of those subsumes them, or joined into one otherwise. *)
+  let limit d =
+    let n = D.cardinal d in
+    if n > !max_paths then
+      max_paths := n;
+    if path_limit > 0 && n > path_limit then (
+      incr merges;
+      let kept, excess = List.split_at (path_limit - 1) (List.rev (D.elements d)) in (* in order of representatives *)
+      let excess = List.filter (fun x -> not (List.exists (Spec.D.leq x) kept)) excess in
+      let d' = match excess with
+        | [] -> D.of_list kept
+        | x :: xs -> D.of_list (List.fold_left Spec.D.join x xs :: kept)
+      in
+      merged_paths := !merged_paths + n - D.cardinal d';
+      d'
+    )
+    else
+      d
+
   type marshal = Spec.marshal
-  let init = Spec.init
-  let finalize = Spec.finalize
+  let init marshal =
+    max_paths := 0;
+    merges := 0;
+    merged_paths := 0;
+    Spec.init marshal
+  let finalize () =
+    if path_limit > 0 then
+      Logs.info "PathSensitive2: at most %d paths, %d merges removing %d paths due to ana.path_sens_limit" !max_paths !merges !merged_paths
+    else
+      Logs.debug "PathSensitive2: at most %d paths" !max_paths;
+    Spec.finalize ()
 
   let startcontext () = Spec.startcontext ()
   let exitstate  v = D.singleton (Spec.exitstate  v)
@@ -561,12 +596,24 @@ struct
 
 
   let map man f g =
+    let unchanged = ref true in
     let h x xs =
-      try D.add (g (f (conv man x))) xs
-      with Deadcode -> xs
+      match g (f (conv man x)) with
+      | x' ->
+        if x' != x then
+          unchanged := false;
+        x' :: xs
+      | exception Deadcode ->
+        unchanged := false;
+        xs
     in
-    let d = D.fold h man.local (D.empty ()) in
-    if D.is_bot d then raise Deadcode else d
+    let xs = D.fold h man.local [] in
+    if !unchanged && not (D.is_bot man.local) then
+      man.local (* propagate unchanged paths without rebuilding buckets *)
+    else (
+      let d = D.of_list xs in
+      if D.is_bot d then raise Deadcode else limit d
+    )
 
   let fold' man f g h a =
     let k x a =
@@ -627,7 +674,7 @@ struct
         y
     in
     let d = D.fold k d (D.bot ()) in
-    if D.is_bot d then raise Deadcode else d
+    if D.is_bot d then raise Deadcode else limit d
 
   let combine_assign man l fe f a fc d f_ask =
     assert (D.cardinal man.local = 1);
@@ -643,7 +690,7 @@ struct
         y
     in
     let d = D.fold k d (D.bot ()) in
-    if D.is_bot d then raise Deadcode else d
+    if D.is_bot d then raise Deadcode else limit d
 end
 
 module DeadBranchLifter (S: Spec): Spec =
@@ -729,6 +776,14 @@ struct
                 ()
             ) em;
       end
+    | IterGlobalComponents (g, f) ->
+      let g: V.t = Obj.obj g in
+      begin match g with
+        | `Left g' ->
+          S.query (conv man) (IterGlobalComponents (Obj.repr g', f))
+        | `Right _ ->
+          f "deadbranch.G" (Obj.repr (man.global g))
+      end
     | InvariantGlobal g ->
       let g: V.t = Obj.obj g in
       begin match g with
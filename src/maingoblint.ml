@@ -144,6 +144,7 @@ let check_arguments () =
   if get_bool "ana.base.context.interval" && not (get_bool "ana.base.context.int") then (set_bool "ana.base.context.interval" false; warn "ana.base.context.interval implicitly disabled by ana.base.context.int");
   if get_bool "incremental.only-rename" then (set_bool "incremental.load" true; warn "incremental.only-rename implicitly activates incremental.load. Previous AST is loaded for diff and rename, but analyis results are not reused.");
   if get_bool "incremental.restart.sided.enabled" && get_string_list "incremental.restart.list" <> [] then warn "Passing a non-empty list to incremental.restart.list (manual restarting) while incremental.restart.sided.enabled (automatic restarting) is activated.";
+  if get_string "incremental.summaries.load" <> "" && get_bool "incremental.load" then fail "incremental.summaries.load is incompatible with incremental.load";
   if get_bool "ana.autotune.enabled" && get_bool "incremental.load" then (set_bool "ana.autotune.enabled" false; warn "ana.autotune.enabled implicitly disabled by incremental.load");
   if get_bool "exp.basic-blocks" && not (get_bool "justcil") && List.mem "assert" @@ get_string_list "trans.activated" then (set_bool "exp.basic-blocks" false; warn "The option exp.basic-blocks implicitely disabled by activating the \"assert\" tranformation.");
   if (not @@ get_bool "witness.invariant.all-locals") && (not @@ get_bool "cil.addNestedScopeAttr") then (set_bool "cil.addNestedScopeAttr" true; warn "Disabling witness.invariant.all-locals implicitly enables cil.addNestedScopeAttr.");
@@ -430,13 +431,19 @@ let preprocess_files () =
     List.concat_map (preprocess_arg_file ~preprocess:true) !extra_files
   in
   if not (get_bool "pre.exist") then (
-    let preprocess_tasks = List.filter_map snd preprocessed in
+    let preprocess_tasks =
+      List.filter_map (fun (preprocessed_file, task_opt) ->
+          Option.map (fun task -> (preprocessed_file, task)) task_opt
+        ) preprocessed
+      |> Timing.wrap "preprocess cache" PreprocessCache.filter
+    in
     let terminated (task: ProcessPool.task) = function
       | Unix.WEXITED 0 -> ()
       | process_status ->
         raise (FrontendError (Format.sprintf "preprocessor %s: %s" (GobUnix.string_of_process_status process_status) task.command))
     in
-    Timing.wrap "preprocess" (ProcessPool.run ~jobs:(GobConfig.jobs ()) ~terminated) preprocess_tasks
+    Timing.wrap "preprocess" (ProcessPool.run ~jobs:(GobConfig.jobs ()) ~terminated) (List.map snd preprocess_tasks);
+    Timing.wrap "preprocess cache" PreprocessCache.store_all preprocess_tasks
   );
   preprocessed
 
@@ -646,7 +653,8 @@ let diff_and_rename current_file =
       if Serialize.results_exist () && GobConfig.get_bool "incremental.load" then begin
         Serialize.Cache.load_data ();
         let old_file = Serialize.Cache.(get_data CilFile) in
-        let changes = CompareCIL.compareCilFiles old_file current_file in
+        let old_fingerprints = Serialize.Cache.(get_opt_data Fingerprints) in
+        let changes = CompareCIL.compareCilFiles ?old_fingerprints old_file current_file in
         let max_ids = Serialize.Cache.(get_data VersionData) in
         let max_ids = UpdateCil.update_ids old_file max_ids current_file changes in
 
@@ -672,6 +680,11 @@ let diff_and_rename current_file =
     if GobConfig.get_bool "incremental.save" then begin
       Serialize.Cache.(update_data CilFile current_file);
       Serialize.Cache.(update_data VersionData max_ids);
+      (* fingerprint after update_ids, which may replace function bodies *)
+      if GobConfig.get_bool "incremental.fingerprint" then
+        Serialize.Cache.(update_data Fingerprints (FingerprintCIL.file current_file))
+      else
+        Serialize.Cache.(reset_data Fingerprints);
     end;
     match old_file, solver_data with
     | Some cil_file, Some solver_data -> Some {server = false; Analyses.changes = changes; restarting; solver_data}
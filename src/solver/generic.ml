@@ -14,17 +14,14 @@ module LoadRunSolver: GenericEqSolver =
       let solver = Fpath.(load_run / solver_file) in
       Logs.debug "Loading the solver result of a saved run from %s" (Fpath.to_string solver);
       let vh: S.d VH.t = Serialize.unmarshal solver in
-      if get_bool "ana.opt.hashcons" then (
-        let vh' = VH.create (VH.length vh) in
-        VH.iter (fun x d ->
-            let x' = S.Var.relift x in
-            let d' = S.Dom.relift d in
-            VH.replace vh' x' d'
-          ) vh;
-        vh'
-      )
-      else
-        vh
+      (* hashconsed values, at least interned expressions, get their tags from this process *)
+      let vh' = VH.create (VH.length vh) in
+      VH.iter (fun x d ->
+          let x' = S.Var.relift x in
+          let d' = S.Dom.relift d in
+          VH.replace vh' x' d'
+        ) vh;
+      vh'
   end
 
 module LoadRunIncrSolver: GenericEqIncrSolver =
@@ -58,8 +55,75 @@ struct
         HM.add histo v 1
       end
 
+  (* solvers can assign this to add sizes of their data structures to the statistics series *)
+  let solver_sizes: (unit -> (string * int) list) ref = ref (fun () -> [])
+
+  let series = SolverStats.Series.enabled ()
+  let series_top = if series then get_int "dbg.solver-stats-series.top" else 0
+  let eval_counts: int HM.t = HM.create (if series_top > 0 then 1024 else 1)
+
+  (** At most [series_top] unknowns with the most evaluations, paired with their counts.
+      Since counts only increase, every other unknown has at most as many evaluations as the least of them. *)
+  module TopEvals = Set.Make (struct
+      type t = int * Var.t
+      let compare (n1, x1) (n2, x2) =
+        let c = Int.compare n1 n2 in
+        if c <> 0 then c else Var.compare x1 x2
+    end)
+  let top_evals = ref TopEvals.empty
+  let top_evals_size = ref 0
+
+  let count_eval x =
+    let n = Option.default 0 (HM.find_opt eval_counts x) in
+    HM.replace eval_counts x (n + 1);
+    if TopEvals.mem (n, x) !top_evals then
+      top_evals := TopEvals.add (n + 1, x) (TopEvals.remove (n, x) !top_evals)
+    else if !top_evals_size < series_top then (
+      top_evals := TopEvals.add (n + 1, x) !top_evals;
+      incr top_evals_size
+    )
+    else (
+      let (least_n, _) as least = TopEvals.min_elt !top_evals in
+      if n + 1 > least_n then
+        top_evals := TopEvals.add (n + 1, x) (TopEvals.remove least !top_evals)
+    )
+
+  let series_row () =
+    let gc = Gc.quick_stat () in
+    let top =
+      TopEvals.fold (fun (n, x) acc ->
+          `Assoc [("var", `String (GobPretty.sprint Var.pretty_trace x)); ("evals", `Int n)] :: acc
+        ) !top_evals [] (* descending *)
+    in
+    let memo = List.rev_map (fun (stats: TagMemo.stats) ->
+        (stats.name, `Assoc [("hits", `Int stats.hits); ("misses", `Int stats.misses)])
+      ) !TagMemo.registered
+    in
+    `Assoc [
+      ("time", `Float (Unix.gettimeofday ()));
+      ("cpu", `Float (Sys.time ()));
+      ("vars", `Int !SolverStats.vars);
+      ("evals", `Int !SolverStats.evals);
+      ("destabilizations", `Int !SolverStats.destabilizations);
+      ("narrow_reuses", `Int !SolverStats.narrow_reuses);
+      ("widenings", `Int !SolverStats.widenings);
+      ("narrowings", `Int !SolverStats.narrowings);
+      ("sides", `Int !SolverStats.sides);
+      ("memo", `Assoc memo);
+      ("sizes", `Assoc (List.map (fun (name, n) -> (name, `Int n)) (!solver_sizes ())));
+      ("gc", `Assoc [
+          ("minor_collections", `Int gc.Gc.minor_collections);
+          ("major_collections", `Int gc.Gc.major_collections);
+          ("heap_words", `Int gc.Gc.heap_words);
+          ("top_heap_words", `Int gc.Gc.top_heap_words);
+        ]);
+      ("top", `List top);
+    ]
+
   let start_event () = ()
-  let stop_event () = ()
+  let stop_event () =
+    if series then
+      SolverStats.Series.write (series_row ())
 
   let new_var_event x =
     incr SolverStats.vars;
@@ -68,10 +132,19 @@ struct
   let get_var_event x =
     if tracing && full_trace then trace "sol" "Querying %a" Var.pretty_trace x
 
+  let solver_progress = get_bool "dbg.solver-progress"
+
   let eval_rhs_event x =
     if tracing && full_trace then trace "sol" "(Re-)evaluating %a" Var.pretty_trace x;
     incr SolverStats.evals;
-    if (get_bool "dbg.solver-progress") then (incr stack_d; Logs.debug "%d" !stack_d)
+    if series then (
+      if series_top > 0 then
+        count_eval x;
+      (* check time only every 256 evaluations *)
+      if !SolverStats.evals land 255 = 0 && SolverStats.Series.due () then
+        SolverStats.Series.write (series_row ())
+    );
+    if solver_progress then (incr stack_d; Logs.debug "%d" !stack_d)
 
   let update_var_event x o n =
     if tracing then increase x;
@@ -130,10 +203,14 @@ struct
     (* if read_line () = "n" then raise Break *)
 
   let () =
-    let write_header = write_csv ["runtime"; "vars"; "evals"; "contexts"; "max_heap"] (* TODO @ !solver_stats_headers *) in
+    let write_header = write_csv ["runtime"; "vars"; "evals"; "contexts"; "max_heap"] (* richer statistics are in dbg.solver-stats-series *) in
     Option.may write_header stats_csv;
     (* call print_stats on dbg.solver-signal *)
-    Sys.set_signal (GobSys.signal_of_string (get_string "dbg.solver-signal")) (Signal_handle print_stats);
+    Sys.set_signal (GobSys.signal_of_string (get_string "dbg.solver-signal")) (Signal_handle (fun s ->
+        print_stats s;
+        if HeapBreakdown.enabled () then
+          !SolverStats.heap_breakdown ()
+      ));
     (* call print_stats every dbg.solver-stats-interval *)
     Sys.set_signal Sys.sigvtalrm (Signal_handle print_stats);
     (* https://ocaml.org/api/Unix.html#TYPEinterval_timer ITIMER_VIRTUAL is user time; sends sigvtalarm; ITIMER_PROF/sigprof is already used in Timeout.Unix.timeout *)
@@ -24,11 +24,6 @@ module Make =
   struct
     type marshal = Obj.t (* cannot use Sol.marshal because cannot unpack first-class module in applicative functor *)
 
-    let copy_marshal (marshal: marshal) =
-      let module Sol = (val choose_solver (get_string "solver") : GenericEqIncrSolver) in
-      let module F = Sol (Arg) (S) (VH) in
-      Obj.repr (F.copy_marshal (Obj.obj marshal))
-
     let relift_marshal (marshal: marshal) =
       let module Sol = (val choose_solver (get_string "solver") : GenericEqIncrSolver) in
       let module F = Sol (Arg) (S) (VH) in
@@ -3,11 +3,76 @@
 let vars = ref 0
 let evals = ref 0
 let narrow_reuses = ref 0
+let destabilizations = ref 0
+let widenings = ref 0
+let narrowings = ref 0
+let sides = ref 0
+
+(** Time series of statistics during solving as JSON lines in [dbg.solver-stats-series.file]. *)
+module Series =
+struct
+  let oc: out_channel option ref = ref None
+  let last = ref 0.
+
+  let enabled () = GobConfig.get_string "dbg.solver-stats-series.file" <> ""
+
+  (** Whether [dbg.solver-stats-series.interval] has passed since the last row. *)
+  let due () =
+    let now = Unix.gettimeofday () in
+    if now -. !last >= float_of_int (GobConfig.get_int "dbg.solver-stats-series.interval") /. 1000. then (
+      last := now;
+      true
+    )
+    else
+      false
+
+  (** Write a row and flush, such that the file can be followed during solving. *)
+  let write json =
+    let oc = match !oc with
+      | Some oc -> oc
+      | None ->
+        let oc' = open_out (GobConfig.get_string "dbg.solver-stats-series.file") in
+        oc := Some oc';
+        oc'
+    in
+    Yojson.Safe.to_channel oc json;
+    output_char oc '\n';
+    flush oc
+
+  let close () =
+    Option.iter close_out !oc;
+    oc := None;
+    last := 0.
+end
+
+(** Named roots of solver data for [dbg.heap-breakdown]. Solvers can assign this. *)
+let heap_tables: (unit -> (string * Obj.t) list) ref = ref (fun () -> [])
+
+(** Iterate over unknowns and their values in solver data for [dbg.heap-breakdown]. Solvers can assign this.
+    [Obj.t]s represent variables and values of the solved {!ConstrSys.EqConstrSys}. *)
+let heap_iter: ((Obj.t -> Obj.t -> unit) -> unit) ref = ref (fun _ -> ())
+
+(** Report heap breakdown on [dbg.solver-signal]. Assigned by the caller of the solver, which knows the analyses. *)
+let heap_breakdown: (unit -> unit) ref = ref (fun () -> ())
 
 let print () =
-  Logs.info "vars = %d    evals = %d    narrow_reuses = %d" !vars !evals !narrow_reuses
+  Logs.info "vars = %d    evals = %d    narrow_reuses = %d    destabilizations = %d" !vars !evals !narrow_reuses !destabilizations;
+  Logs.info "widenings = %d    narrowings = %d    sides = %d" !widenings !narrowings !sides;
+  List.iter (fun (stats: TagMemo.stats) ->
+      if stats.hits + stats.misses > 0 then
+        Logs.info "memo %s: hits = %d    misses = %d" stats.name stats.hits stats.misses
+    ) (List.rev !TagMemo.registered)
 
 let reset () =
   vars := 0;
   evals := 0;
-  narrow_reuses := 0
+  narrow_reuses := 0;
+  destabilizations := 0;
+  widenings := 0;
+  narrowings := 0;
+  sides := 0;
+  Series.close ();
+  List.iter (fun (stats: TagMemo.stats) ->
+      stats.hits <- 0;
+      stats.misses <- 0
+    ) !TagMemo.registered
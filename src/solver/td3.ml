@@ -112,20 +112,36 @@ module Base =
         (* vice versa doesn't currently hold, because stable is not pruned *)
       )
 
-    let copy_marshal (data: marshal): marshal =
-      {
-        rho = HM.copy data.rho;
-        stable = HM.copy data.stable;
-        wpoint = HM.copy data.wpoint;
-        infl = HM.copy data.infl;
-        sides = HM.copy data.sides;
-        side_infl = HM.copy data.side_infl;
-        side_dep = HM.copy data.side_dep;
-        st = data.st; (* data.st is immutable *)
-        var_messages = HM.copy data.var_messages;
-        rho_write = HM.map (fun x w -> HM.copy w) data.rho_write; (* map copies outer HM *)
-        dep = HM.copy data.dep;
-      }
+    (** Outer keys of [rho_write], whose inner tables have been saved in the current transaction. *)
+    let rho_write_saved: unit HM.t = HM.create 10
+
+    (** Register old data with the journal of a server mode transaction (see {!HashtblJournal}), before mutating it.
+        Inner tables of [rho_write] are mutated in place, so they are saved lazily by {!journal_write} instead of registering each of them. *)
+    let journal_data (data: marshal) =
+      if !HashtblJournal.active then (
+        HashtblJournal.register data.rho;
+        HashtblJournal.register data.stable;
+        HashtblJournal.register data.wpoint;
+        HashtblJournal.register data.infl;
+        HashtblJournal.register data.sides;
+        HashtblJournal.register data.side_infl;
+        HashtblJournal.register data.side_dep;
+        HashtblJournal.register data.var_messages;
+        HashtblJournal.register data.rho_write;
+        HashtblJournal.register data.dep;
+        HM.clear rho_write_saved
+      )
+
+    (** Save bindings of inner table [w] of [rho_write] at [x] before its first mutation in a server mode transaction. *)
+    let journal_write x w =
+      if !HashtblJournal.active && not (HM.mem rho_write_saved x) then (
+        HM.replace rho_write_saved x ();
+        let bindings = HM.fold (fun y d acc -> (y, d) :: acc) w [] in (* reverses order of shadowed bindings, such that adding restores it *)
+        HashtblJournal.record (fun () ->
+            HM.clear w;
+            List.iter (fun (y, d) -> HM.add w y d) bindings
+          )
+      )
 
     (* The following hack is for fixing hashconsing.
        If hashcons is enabled now, then it also was for the loaded values (otherwise it would crash). If it is off, we don't need to do anything.
@@ -202,6 +218,7 @@ module Base =
       let data =
         match marshal with
         | Some data ->
+          journal_data data;
           if not reuse_stable then (
             Logs.info "Destabilizing everything!";
             HM.clear data.stable;
@@ -229,7 +246,11 @@ module Base =
       let stable = data.stable in
 
       let narrow_reuse = GobConfig.get_bool "solvers.td3.narrow-reuse" in
+      let callgraph_order = GobConfig.get_bool "solvers.td3.callgraph-order" in
       let remove_wpoint = GobConfig.get_bool "solvers.td3.remove-wpoint" in
+      (* these side_widen strategies check for destabilization immediately after the side effect, which batching defers *)
+      let side_batch = GobConfig.get_bool "solvers.td3.side-batch" && not (List.mem side_widen ["cycle"; "unstable_self"; "unstable_called"]) in
+      let side_pending = HM.create 10 in (* side-effected unknowns, whose influences haven't been destabilized yet *)
 
       let side_dep = data.side_dep in
       let side_infl = data.side_infl in
@@ -246,7 +267,11 @@ module Base =
          These don't have to be re-verified and warnings can be reused. *)
       let superstable = HM.copy stable in
 
-      let reluctant = GobConfig.get_bool "incremental.reluctant.enabled" in
+      let demand_funs = GobConfig.get_string_list "incremental.demand.funs" in
+      let demand = demand_funs <> [] && GobConfig.get_bool "incremental.load" in
+      let reluctant = GobConfig.get_bool "incremental.reluctant.enabled" || demand in
+      let demand_evaluated = Hashtbl.create 10 in (* names of functions, whose unknowns were evaluated in demand-driven mode *)
+      let abort_evals = GobConfig.get_int "dbg.abort-evals" in
 
       let var_messages = data.var_messages in
       let rho_write = data.rho_write in
@@ -257,6 +282,19 @@ module Base =
           Logs.info "|called|=%d" (HM.length called);
           print_context_stats rho
       in
+      (* these keep the tables alive, so they are only assigned when used and unassigned when solve returns *)
+      if SolverStats.Series.enabled () then (
+        solver_sizes := fun () ->
+          [("rho", HM.length rho); ("infl", HM.length infl); ("stable", HM.length stable); ("wpoint", HM.length wpoint); ("called", HM.length called)]
+      );
+      if HeapBreakdown.enabled () then (
+        SolverStats.heap_tables := (fun () ->
+            [("rho", Obj.repr rho); ("stable", Obj.repr stable); ("infl", Obj.repr infl); ("wpoint", Obj.repr wpoint); ("sides", Obj.repr sides); ("side_dep", Obj.repr side_dep); ("side_infl", Obj.repr side_infl); ("var_messages", Obj.repr var_messages); ("rho_write", Obj.repr rho_write); ("dep", Obj.repr dep); ("called", Obj.repr called); ("superstable", Obj.repr superstable)]
+          );
+        SolverStats.heap_iter := (fun f ->
+            HM.iter (fun x d -> f (Obj.repr x) (Obj.repr d)) rho
+          )
+      );
 
       if GobConfig.get_bool "incremental.load" then (
         print_data_verbose data "Loaded data for incremental analysis";
@@ -265,6 +303,58 @@ module Base =
 
       let cache_sizes = ref [] in
 
+      (* Per-function budgets: unknowns of functions, which exceed their number of evaluations or exclusive evaluation time, are degraded to immediate widening without narrowing. *)
+      let budget_evals = GobConfig.get_int "solvers.td3.budget.evals" in
+      let budget_time = float_of_int (GobConfig.get_int "solvers.td3.budget.time") /. 1000. in
+      let budgets = budget_evals > 0 || budget_time > 0. in
+      let module FH = Hashtbl.Make (CilType.Fundec) in
+      let budget_used: (int ref * float ref) FH.t = FH.create 10 in
+      let degraded: (int * float) FH.t = FH.create 10 in (* evals and time when degraded *)
+      let budget_current: float ref option ref = ref None in (* time of function currently evaluated *)
+      let budget_last = ref 0. in
+      let budget_fundec x =
+        match Node.find_fundec (S.Var.node x) with
+        | fd when fd != GoblintCil.dummyFunDec -> Some fd
+        | _ -> None
+        | exception Not_found -> None
+      in
+      let budget_charge () =
+        let now = Unix.gettimeofday () in
+        Option.may (fun time -> time := !time +. now -. !budget_last) !budget_current;
+        budget_last := now
+      in
+      let with_budget x f =
+        match budget_fundec x with
+        | Some fd when budgets ->
+          let (evals, time) =
+            FH.find_option budget_used fd |> Option.default_delayed (fun () ->
+                let used = (ref 0, ref 0.) in
+                FH.replace budget_used fd used;
+                used
+              )
+          in
+          incr evals;
+          budget_charge ();
+          let prev = !budget_current in
+          budget_current := Some time;
+          Fun.protect ~finally:(fun () ->
+              budget_charge ();
+              budget_current := prev;
+              if not (FH.mem degraded fd) && (budget_evals > 0 && !evals > budget_evals || budget_time > 0. && !time > budget_time) then (
+                Logs.debug "Function %s exceeded its budget after %d evaluations and %.3fs, degrading" fd.svar.vname !evals !time;
+                FH.replace degraded fd (!evals, !time)
+              )
+            ) f
+        | _ -> f ()
+      in
+      let is_degraded x =
+        budgets && FH.length degraded > 0 && (
+          match budget_fundec x with
+          | Some fd -> FH.mem degraded fd
+          | None -> false
+        )
+      in
+
       let add_infl y x =
         if tracing then trace "sol2" "add_infl %a %a" S.Var.pretty_trace y S.Var.pretty_trace x;
         HM.replace infl y (VS.add x (try HM.find infl y with Not_found -> VS.empty));
@@ -315,18 +405,22 @@ module Base =
             | _ ->
               (* The RHS is re-evaluated, all deps are re-trigerred *)
               HM.replace dep x VS.empty;
-              eq x (eval l x) (side ~x)
+              with_budget x (fun () -> eq x (eval l x) (side ~x))
           in
           HM.remove called x;
           let old = HM.find rho x in (* d from older solve *) (* find old value after eq since wpoint restarting in eq/eval might have changed it meanwhile *)
+          let degraded = is_degraded x in (* immediately widen and never narrow unknowns over budget *)
           let wpd = (* d after widen/narrow (if wp) *)
-            if not wp then eqd
-            else if term then
+            if not wp && not degraded then eqd
+            else if term || degraded then
               match phase with
-              | Widen -> S.Dom.widen old (S.Dom.join old eqd)
-              | Narrow when GobConfig.get_bool "exp.no-narrow" -> old (* no narrow *)
+              | Widen ->
+                incr SolverStats.widenings;
+                S.Dom.widen old (S.Dom.join old eqd)
+              | Narrow when GobConfig.get_bool "exp.no-narrow" || degraded -> old (* no narrow *)
               | Narrow ->
                 (* assert S.Dom.(leq eqd old || not (leq old eqd)); (* https://github.com/goblint/analyzer/pull/490#discussion_r875554284 *) *)
+                incr SolverStats.narrowings;
                 S.Dom.narrow old eqd
             else
               box old eqd
@@ -368,7 +462,16 @@ module Base =
         if tracing then trace "sol2" "eq %a" S.Var.pretty_trace x;
         match Hooks.system x with
         | None -> S.Dom.bot ()
-        | Some f -> f get set
+        | Some f ->
+          eval_rhs_event x; (* counts right-hand sides skipped by DepVals as well *)
+          if abort_evals > 0 && !SolverStats.evals >= abort_evals then
+            raise Sys.Break; (* like an interactive abort *)
+          if demand then (
+            match Node.find_fundec (S.Var.node x) with
+            | fd -> Hashtbl.replace demand_evaluated fd.svar.vname ()
+            | exception Not_found -> ()
+          );
+          f get set
       and simple_solve l x y =
         if tracing then trace "sol2" "simple_solve %a (rhs: %b)" S.Var.pretty_trace y (Hooks.system y <> None);
         if Hooks.system y = None then (init y; HM.replace stable y (); HM.find rho y) else
@@ -411,9 +514,11 @@ module Base =
           Logs.warn "side-effect to unknown w/ rhs: %a, contrib: %a" S.Var.pretty_trace y S.Dom.pretty d;
         );
         assert (Hooks.system y = None);
+        incr SolverStats.sides;
         init y;
         (match x with None -> () | Some x -> if side_widen = "unstable_self" then add_infl x y);
         let widen a b =
+          incr SolverStats.widenings;
           if M.tracing then M.traceli "sol2" "side widen %a %a" S.Dom.pretty a S.Dom.pretty b;
           let r = S.Dom.widen a (S.Dom.join a b) in
           if M.tracing then M.traceu "sol2" "-> %a" S.Dom.pretty r;
@@ -428,6 +533,7 @@ module Base =
               | _ -> S.Dom.join a b
             )
           | _ when HM.mem wpoint y  -> widen a b
+          | _ when Option.map_default is_degraded false x -> widen a b
           | _ -> S.Dom.join a b
         in
         let old = HM.find rho y in
@@ -446,7 +552,10 @@ module Base =
           in
           (* HM.replace rho y ((if HM.mem wpoint y then S.Dom.widen old else identity) (S.Dom.join old d)); *)
           HM.replace rho y tmp;
-          if side_widen <> "cycle" then destabilize y;
+          if side_batch then
+            HM.replace side_pending y ()
+          else if side_widen <> "cycle" then
+            destabilize y;
           (* make y a widening point if ... This will only matter for the next side _ y.  *)
           let wpoint_if e =
             if e then (
@@ -506,6 +615,7 @@ module Base =
         HM.replace infl x VS.empty;
         VS.iter (fun y ->
             if tracing then trace "sol2" "stable remove %a" S.Var.pretty_trace y;
+            incr SolverStats.destabilizations;
             HM.remove stable y;
             HM.remove superstable y;
             Hooks.stable_remove y;
@@ -513,6 +623,76 @@ module Base =
           ) w
       in
 
+      (* In demand-driven mode, destabilization stays within the demanded functions.
+         Other influenced unknowns keep their old values during this run and are destabilized after postsolving for the next run. *)
+      let demand_deferred = HM.create 10 in
+      let is_demanded x =
+        match Node.find_fundec (S.Var.node x) with
+        | fd -> List.mem fd.svar.vname demand_funs
+        | exception Not_found -> false
+      in
+      let rec destabilize_demand x =
+        if tracing then trace "sol2" "destabilize_demand %a" S.Var.pretty_trace x;
+        let w = HM.find_default infl x VS.empty in
+        HM.replace infl x VS.empty;
+        VS.iter (fun y ->
+            if is_demanded y then (
+              if tracing then trace "sol2" "stable remove %a" S.Var.pretty_trace y;
+              incr SolverStats.destabilizations;
+              HM.remove stable y;
+              HM.remove superstable y;
+              Hooks.stable_remove y;
+              if not (HM.mem called y) then destabilize_demand y
+            )
+            else
+              HM.replace demand_deferred y ()
+          ) w
+      in
+
+      (* Stable sort by a rank, whose first component is the SCC of the unknown's function in the static call graph, callees first. *)
+      let sort_by_callgraph rank xs =
+        let callgraph_rank x =
+          match Node.find_fundec (S.Var.node x) with
+          | fd -> (try Cilfacade.find_varinfo_callgraph_rank fd.svar with Not_found -> max_int)
+          | exception Not_found -> max_int
+        in
+        xs
+        |> List.map (fun x -> ((callgraph_rank x, rank x), x))
+        |> List.stable_sort (fun (r1, _) (r2, _) -> Stdlib.compare r1 r2)
+        |> List.map snd
+      in
+
+      (* Order by call graph SCCs, callees first, and widening points first within the same SCC.
+         Solving callees before their callers avoids re-solving them when the callers' contexts evolve. *)
+      let callgraph_sort xs =
+        if callgraph_order then
+          sort_by_callgraph (fun x -> not (HM.mem wpoint x)) xs
+        else
+          xs
+      in
+
+      (* Destabilize influences of batched side effects and re-solve them in priority order:
+         by call graph SCCs, callees first, and by position in the function, such that side effects from earlier readers are coalesced before later readers are solved. *)
+      let rec flush_sides () =
+        if HM.length side_pending > 0 then (
+          let ys = HM.keys side_pending |> List.of_enum in
+          HM.clear side_pending;
+          let readers = List.fold_left (fun acc y -> VS.union acc (HM.find_default infl y VS.empty)) VS.empty ys in
+          List.iter destabilize ys;
+          let node_rank x =
+            match S.Var.node x with
+            | FunctionEntry _ -> -1
+            | Statement s -> s.sid
+            | Function _ -> max_int
+          in
+          VS.elements readers
+          |> List.filter (fun x -> Hooks.system x <> None)
+          |> sort_by_callgraph node_rank
+          |> List.iter (fun x -> if not (HM.mem stable x) then solve x Widen);
+          flush_sides ()
+        )
+      in
+
       start_event ();
 
       (* reluctantly unchanged return nodes to additionally query for postsolving to get warnings, etc. *)
@@ -611,7 +791,9 @@ module Base =
         in
 
         destabilize_ref :=
-          if restart_sided then (
+          if demand then
+            destabilize_demand
+          else if restart_sided then (
             let side_fuel =
               match GobConfig.get_int "incremental.restart.sided.fuel" with
               | fuel when fuel >= 0 -> Some fuel
@@ -752,7 +934,7 @@ module Base =
             ) rho_write
         );
         delete_marked rho_write;
-        HM.iter (fun x w -> delete_marked w) rho_write;
+        HM.iter (fun x w -> journal_write x w; delete_marked w) rho_write;
 
         print_data_verbose data "Data after clean-up";
 
@@ -762,17 +944,23 @@ module Base =
           (* solve on the return node of changed functions. Only destabilize the function's return node if the analysis result changed *)
           Logs.debug "Separately solving changed functions...";
           HM.iter (fun x (old_rho, old_infl) -> HM.replace rho x old_rho; HM.replace infl x old_infl) old_ret;
-          HM.iter (fun x (old_rho, old_infl) ->
+          HM.keys old_ret
+          |> List.of_enum
+          |> callgraph_sort
+          |> List.iter (fun x ->
+              let (old_rho, _) = HM.find old_ret x in
               Logs.debug "test for %a" Node.pretty_trace (S.Var.node x);
               solve x Widen;
               if not (S.Dom.equal (HM.find rho x) old_rho) then (
                 Logs.debug "Further destabilization happened ...";
+                if demand then
+                  reluctant_vs := x :: !reluctant_vs (* postsolve changed demanded function from here since callers remain superstable *)
               )
               else (
                 Logs.debug "Destabilization not required...";
                 reluctant_vs := x :: !reluctant_vs
               )
-            ) old_ret;
+            );
 
           Logs.debug "Final solve..."
         );
@@ -780,14 +968,18 @@ module Base =
         List.iter set_start st;
       );
 
-      destabilize_ref := destabilize_normal; (* always use normal destabilize during actual solve *)
+      destabilize_ref := if demand then destabilize_demand else destabilize_normal; (* always use normal destabilize during actual solve, unless demand-driven *)
 
       List.iter init vs;
+      (* only report work of the solving loop, not of incremental destabilization before it *)
+      let evals_start = !SolverStats.evals in
+      let destabilizations_start = !SolverStats.destabilizations in
       (* If we have multiple start variables vs, we might solve v1, then while solving v2 we side some global which v1 depends on with a new value. Then v1 is no longer stable and we have to solve it again. *)
       let i = ref 0 in
       let rec solver () = (* as while loop in paper *)
         incr i;
-        let unstable_vs = List.filter (neg (HM.mem stable)) vs in
+        flush_sides (); (* side effects before the loop, e.g. of start globals or reluctant solving, may not destabilize any start var *)
+        let unstable_vs = callgraph_sort (List.filter (neg (HM.mem stable)) vs) in
         if unstable_vs <> [] then (
           if Logs.Level.should_log Debug then (
             if !i = 1 then Logs.newline ();
@@ -801,6 +993,8 @@ module Base =
         )
       in
       solver ();
+      if callgraph_order then
+        Logs.info "Call graph ordered solving: %d evals, %d destabilizations" (!SolverStats.evals - evals_start) (!SolverStats.destabilizations - destabilizations_start);
       (* Before we solved all unstable vars in rho with a rhs in a loop. This is unneeded overhead since it also solved unreachable vars (reachability only removes those from rho further down). *)
       (* After termination, only those variables are stable which are
        * - reachable from any of the queried variables vs, or
@@ -891,6 +1085,7 @@ module Base =
 
           VH.filteri_inplace (fun x w ->
               if VH.mem reachable x then (
+                journal_write x w;
                 VH.filteri_inplace (fun y _ ->
                     VH.mem reachable y
                   ) w;
@@ -1010,7 +1205,9 @@ module Base =
             HM.replace stable y (); (* make stable just in case, so following incremental load would have in superstable *)
             let w =
               try
-                VH.find rho_write x
+                let w = VH.find rho_write x in
+                journal_write x w;
+                w
               with Not_found ->
                 let w = VH.create 1 in (* only create on demand, modify_def would eagerly allocate *)
                 VH.replace rho_write x w;
@@ -1021,6 +1218,20 @@ module Base =
       end
       in
 
+      (** Report degraded functions as warnings, after IncrWarn has enabled them. *)
+      let module Budget: PostSolver.S with module S = S and module VH = HM =
+      struct
+        include PostSolver.Unit (S) (HM)
+
+        let init () =
+          if FH.length degraded > 0 then
+            Logs.info "%d functions exceeded their solving budget and were degraded" (FH.length degraded);
+          FH.iter (fun fd (evals, time) ->
+              M.warn ~loc:(M.Location.Node (FunctionEntry fd)) ~category:Imprecise "Function %s exceeded its solving budget after %d evaluations and %.3fs: its unknowns were widened immediately and not narrowed" fd.svar.vname evals time
+            ) degraded
+      end
+      in
+
       let module MakeIncrListArg =
       struct
         module Arg =
@@ -1031,7 +1242,7 @@ module Base =
         include PostSolver.ListArgFromStdArg (S) (HM) (Arg)
 
         (* Only put postsolvers defined in here with [S] from [CurrentVarEqConstrSys]! *)
-        let postsolvers = (module IncrPrune: M) :: (module SideInfl: M) :: (module IncrWrite: M) :: (module IncrWarn: M) :: postsolvers
+        let postsolvers = (module IncrPrune: M) :: (module SideInfl: M) :: (module IncrWrite: M) :: (module IncrWarn: M) :: (module Budget: M) :: postsolvers
 
         let init_reachable ~vh =
           if incr_verify then
@@ -1042,12 +1253,31 @@ module Base =
       in
 
       let module Post = PostSolver.MakeIncrList (MakeIncrListArg) in
-      Post.post st (stable_reluctant_vs @ vs) rho;
+      Sampling.wrap_phase "postsolving" (Post.post st (stable_reluctant_vs @ vs)) rho;
 
       print_data_verbose data "Data after postsolve";
 
-      verify_data data;
+      if demand then (
+        let evaluated = List.sort String.compare (List.of_enum (Hashtbl.keys demand_evaluated)) in
+        Logs.info "Demand-driven solving evaluated unknowns of functions: %s" (String.concat ", " evaluated);
+        Logs.debug "Destabilizing %d unknowns influenced by demanded functions for the next run" (HM.length demand_deferred);
+        HM.iter (fun y () ->
+            HM.remove stable y;
+            destabilize_normal y
+          ) demand_deferred
+      )
+      else
+        verify_data data;
       (rho, {st; infl; sides; rho; wpoint; stable; side_dep; side_infl; var_messages; rho_write; dep})
+
+    let solve st vs marshal =
+      Fun.protect ~finally:(fun () ->
+          solver_sizes := (fun () -> []);
+          SolverStats.heap_tables := (fun () -> []);
+          SolverStats.heap_iter := (fun _ -> ())
+        ) (fun () ->
+          solve st vs marshal
+        )
   end
 
 (** TD3 with no hooks. *)
@@ -1065,15 +1295,7 @@ module Basic: GenericEqIncrSolver =
 
       let print_data () = ()
 
-      let system x =
-        match S.system x with
-        | None -> None
-        | Some f ->
-          let f' get set =
-            eval_rhs_event x;
-            f get set
-          in
-          Some f'
+      let system = S.system
 
       let delete_marked _ = ()
       let stable_remove _ = ()
@@ -1134,7 +1356,6 @@ module DepVals: GenericEqIncrSolver =
                 HM.replace dep_vals x (oldv,((y,tmp) :: curr_dep_vals));
                 tmp
               in
-              eval_rhs_event x;
               (* Reset dep_vals to [] *)
               HM.replace dep_vals x (S.Dom.bot (),[]);
               let res = f get set in
@@ -1166,12 +1387,6 @@ module DepVals: GenericEqIncrSolver =
       dep_vals: dep_vals; (** Dependencies of variables and values encountered at last eval of RHS. *)
     }
 
-    let copy_marshal {base; dep_vals} =
-      {
-        base = Base.copy_marshal base;
-        dep_vals = HM.copy dep_vals;
-      }
-
     let relift_marshal {base; dep_vals} =
       let base' = Base.relift_marshal base in
       let dep_vals' = HM.create (HM.length dep_vals) in
@@ -1183,6 +1398,7 @@ module DepVals: GenericEqIncrSolver =
     let solve st vs marshal =
       let base_marshal = match marshal with
         | Some {base; dep_vals} ->
+          HashtblJournal.register dep_vals;
           current_dep_vals := dep_vals;
           Some base
         | None ->
@@ -1284,8 +1284,33 @@ let activated_library_descs: (string, LibraryDesc.t) Hashtbl.t ResettableLazy.t
       |> List.fold_left union (Hashtbl.create 0)
     )
 
+(** Activated descriptors resolved per varinfo, indexed by vid.
+    Each entry also keeps the name it was resolved for, in case a vid is reused for a different function. *)
+let resolved_library_descs: (string * LibraryDesc.t option) option array ref = ref [||]
+
+let find_activated (f: varinfo) =
+  let resolve () = Hashtbl.find_option (ResettableLazy.force activated_library_descs) f.vname in
+  let vid = f.vid in
+  if vid < 0 then
+    resolve ()
+  else (
+    let n = Array.length !resolved_library_descs in
+    if vid >= n then (
+      let resolved = Array.make (max (vid + 1) (2 * n)) None in
+      Array.blit !resolved_library_descs 0 resolved 0 n;
+      resolved_library_descs := resolved
+    );
+    match !resolved_library_descs.(vid) with
+    | Some (name, desc) when String.equal name f.vname -> desc
+    | _ ->
+      let desc = resolve () in
+      !resolved_library_descs.(vid) <- Some (f.vname, desc);
+      desc
+  )
+
 let reset_lazy () =
-  ResettableLazy.reset activated_library_descs
+  ResettableLazy.reset activated_library_descs;
+  resolved_library_descs := [||]
 
 let lib_funs = ref (Set.String.of_list ["__raw_read_unlock"; "__raw_write_unlock"; "spin_trylock"])
 let add_lib_funs funs = lib_funs := List.fold_right Set.String.add funs !lib_funs
@@ -1325,8 +1350,7 @@ let unknown_desc f : LibraryDesc.t =
   }
 
 let find f =
-  let name = f.vname in
-  match Hashtbl.find_option (ResettableLazy.force activated_library_descs) name with
+  match find_activated f with
   | Some desc -> desc
   | None -> unknown_desc f
 
@@ -0,0 +1,149 @@
+(** On-disk cache of preprocessed files across runs (see [pre.cache]).
+
+    A cache entry is keyed by the preprocessing command, its working directory and the version output of its program.
+    It records the digests of all files, which the preprocessed output includes according to its linemarkers,
+    including the source file itself.
+    If all of them are unchanged, the cached output is copied instead of running the preprocessor.
+    Like other such caches, this does not notice a new header, which would shadow an included one in an earlier include directory. *)
+
+(** Included files with their digests. *)
+type entry = (string * Digest.t) list
+
+let enabled () = GobConfig.get_string "pre.cache" <> ""
+
+(** First word of a shell command, possibly quoted by [Filename.quote_command]. *)
+let program command =
+  let command = String.trim command in
+  if String.length command > 0 && command.[0] = '\'' then
+    match String.index_from_opt command 1 '\'' with
+    | Some i -> String.sub command 1 (i - 1)
+    | None -> command
+  else
+    match String.index_opt command ' ' with
+    | Some i -> String.sub command 0 i
+    | None -> command
+
+let versions: (string, string) Hashtbl.t = Hashtbl.create 3
+
+(** Output of [program --version], such that updating the preprocessor invalidates its entries. *)
+let version program =
+  match Hashtbl.find_opt versions program with
+  | Some version -> version
+  | None ->
+    let version =
+      match Unix.open_process_in (Filename.quote_command ~stderr:Filename.null program ["--version"]) with
+      | ic ->
+        let version = In_channel.input_all ic in
+        ignore (Unix.close_process_in ic);
+        version
+      | exception Unix.Unix_error _ -> ""
+    in
+    Hashtbl.replace versions program version;
+    version
+
+let paths (task: ProcessPool.task) =
+  let program = program task.command in
+  let key = Digest.to_hex (Digest.string (Marshal.to_string (task.command, Option.map Fpath.to_string task.cwd, program, version program) [])) in
+  let dir = Fpath.v (GobConfig.get_string "pre.cache") in
+  Fpath.(dir / (key ^ ".i")), Fpath.(dir / (key ^ ".deps"))
+
+let copy_to src oc =
+  let ic = open_in_bin (Fpath.to_string src) in
+  Fun.protect ~finally:(fun () -> close_in ic) (fun () ->
+      let buf = Bytes.create 65536 in
+      let rec loop () =
+        let n = input ic buf 0 (Bytes.length buf) in
+        if n > 0 then (
+          output oc buf 0 n;
+          loop ()
+        )
+      in
+      loop ()
+    )
+
+let copy src dst =
+  let oc = open_out_bin (Fpath.to_string dst) in
+  Fun.protect ~finally:(fun () -> close_out oc) (fun () -> copy_to src oc)
+
+(** Write a temporary file and rename it to [dst], such that concurrent runs never read a partially written file. *)
+let write_atomically dst write =
+  let tmp = Filename.temp_file ~temp_dir:(Fpath.to_string (Fpath.parent dst)) (Fpath.basename dst) ".tmp" in
+  match
+    let oc = open_out_bin tmp in
+    Fun.protect ~finally:(fun () -> close_out oc) (fun () -> write oc)
+  with
+  | () -> Unix.rename tmp (Fpath.to_string dst)
+  | exception e ->
+    Sys.remove tmp;
+    raise e
+
+(** Files from linemarkers of preprocessed output in a single pass, relative to the working directory of the preprocessor. *)
+let included_files (task: ProcessPool.task) preprocessed =
+  let files = Hashtbl.create 17 in
+  let ic = open_in_bin (Fpath.to_string preprocessed) in
+  Fun.protect ~finally:(fun () -> close_in ic) (fun () ->
+      try
+        while true do
+          let line = input_line ic in
+          if String.length line > 2 && line.[0] = '#' && line.[1] = ' ' then (
+            match Scanf.sscanf line "# %_d %S" Fun.id with
+            | file when String.length file > 0 && file.[0] <> '<' -> Hashtbl.replace files file () (* ignore special "paths" like <built-in> *)
+            | _ -> ()
+            | exception (Scanf.Scan_failure _ | Failure _ | End_of_file) -> ()
+          )
+        done
+      with End_of_file -> ()
+    );
+  Hashtbl.to_seq_keys files
+  |> Seq.map (fun file ->
+      match task.cwd with
+      | Some cwd when Filename.is_relative file -> Filename.concat (Fpath.to_string cwd) file
+      | _ -> file
+    )
+  |> List.of_seq
+
+(** Copy cached output of preprocessing task to [preprocessed], if still valid. *)
+let find (task: ProcessPool.task) preprocessed =
+  let (cached, deps) = paths task in
+  match
+    let ic = open_in_bin (Fpath.to_string deps) in
+    Fun.protect ~finally:(fun () -> close_in ic) (fun () -> (Marshal.from_channel ic: entry))
+  with
+  | entry ->
+    let unchanged (file, digest) =
+      match Digest.file file with
+      | digest' -> Digest.equal digest digest'
+      | exception Sys_error _ -> false
+    in
+    List.for_all unchanged entry && (
+      match copy cached preprocessed with
+      | () -> true
+      | exception Sys_error _ -> false
+    )
+  | exception (Sys_error _ | End_of_file | Failure _) -> false
+
+(** Store output of successful preprocessing task. *)
+let store (task: ProcessPool.task) preprocessed =
+  let (cached, deps) = paths task in
+  match List.map (fun file -> (file, Digest.file file)) (included_files task preprocessed) with
+  | (entry: entry) ->
+    GobSys.mkdir_parents deps;
+    (* output before its deps, such that valid deps never refer to missing or partial output *)
+    write_atomically cached (copy_to preprocessed);
+    write_atomically deps (fun oc -> Marshal.to_channel oc entry [])
+  | exception Sys_error _ -> () (* some included file is not readable, so don't cache *)
+
+(** Split preprocessing tasks into ones, which still need to be run, and copy the outputs of the rest from the cache. *)
+let filter tasks =
+  if enabled () then (
+    let misses = List.filter (fun (preprocessed, task) -> not (find task preprocessed)) tasks in
+    Logs.info "Preprocessing cache: %d hits, %d misses" (List.length tasks - List.length misses) (List.length misses);
+    misses
+  )
+  else
+    tasks
+
+(** Store outputs of successfully run preprocessing tasks. *)
+let store_all tasks =
+  if enabled () then
+    List.iter (fun (preprocessed, task) -> store task preprocessed) tasks
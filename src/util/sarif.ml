@@ -136,18 +136,52 @@ let artifacts_of_messages (messages: Messages.Message.t list): Artifact.t list =
     )
   |> List.of_enum
 
+let version = "2.1.0"
+let schema = "https://schemastore.azurewebsites.net/schemas/json/sarif-2.1.0-rtm.5.json"
+
+let invocations (): Invocation.t list = [{
+    commandLine = GobSys.command_line;
+    executionSuccessful = true;
+  }]
+
 let to_yojson messages =
   SarifLog.to_yojson {
-    version = "2.1.0";
-    schema = "https://schemastore.azurewebsites.net/schemas/json/sarif-2.1.0-rtm.5.json";
+    version;
+    schema;
     runs = [{
-        invocations = [{
-            commandLine = GobSys.command_line;
-            executionSuccessful = true;
-          }];
+        invocations = invocations ();
         artifacts = artifacts_of_messages messages;
         tool = goblintTool;
         defaultSourceLanguage = "C";
         results = List.concat_map result_of_message messages;
       }]
   }
+
+(** Write Sarif output of messages from [iter] to [oc] result by result, without constructing it in memory.
+    Artifacts are written after results, because they are only known at the end. *)
+let to_channel oc (iter: (Messages.Message.t -> unit) -> unit) =
+  let json_string json = Yojson.Safe.to_string ~std:true json in
+  Stdlib.Printf.fprintf oc {|{"version":%s,"$schema":%s,"runs":[{"tool":%s,"defaultSourceLanguage":"C","invocations":%s,"results":[|}
+    (json_string (`String version))
+    (json_string (`String schema))
+    (json_string (Tool.to_yojson goblintTool))
+    (json_string (`List (List.map Invocation.to_yojson (invocations ()))));
+  let first = ref true in
+  let files = Hashtbl.create 13 in
+  let artifacts = ref [] in
+  iter (fun message ->
+      List.iter (fun result ->
+          if !first then
+            first := false
+          else
+            Stdlib.output_char oc ',';
+          Yojson.Safe.to_channel ~std:true oc (Result.to_yojson result)
+        ) (result_of_message message);
+      List.iter (fun file ->
+          if not (Hashtbl.mem files file) then (
+            Hashtbl.replace files file ();
+            artifacts := {Artifact.location = { uri = file }} :: !artifacts
+          )
+        ) (files_of_message message)
+    );
+  Stdlib.Printf.fprintf oc {|],"artifacts":%s}]}|} (json_string (`List (List.rev_map Artifact.to_yojson !artifacts)))
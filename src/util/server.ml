@@ -222,6 +222,8 @@ let virtual_changes file =
   let eq ?(matchVars=true) ?(matchFuns=true) ?(renameDetection=false) _ _ _ gc_old (gc_new: CompareCIL.global_col) ((change_info : CompareCIL.change_info), final_matches) = (match gc_new.def with
       | Some (Fun fdec) when CompareCIL.should_reanalyze fdec ->
         change_info.exclude_from_rel_destab <- CompareCIL.VarinfoSet.add fdec.svar change_info.exclude_from_rel_destab
+      | Some (Fun fdec) when CompareCIL.should_demand fdec ->
+        change_info.changed <- {old = gc_old; current = gc_new; unchangedHeader = true; diff = None} :: change_info.changed
       | _ -> change_info.unchanged <- {old = gc_old; current= gc_new} :: change_info.unchanged);
     change_info, final_matches
   in
@@ -272,16 +274,28 @@ let node_locator: Locator.t ResettableLazy.t =
       locator
     )
 
-let analyze ?(reset=false) (s: t) =
+let analyze ?(reset=false) ?(demand=[]) (s: t) =
+  (* validate demand before any state changes, such that a rejected request keeps the previous results *)
+  if demand <> [] && (reset || Option.is_none (Serialize.Cache.get_opt_data SolverData)) then
+    Response.Error.(raise (make ~code:RequestFailed ~message:"Demand-driven analysis requires results of a previous analysis" ()));
+  let file, reparsed = reparse s in
+  List.iter (fun fname ->
+      let is_fun = function
+        | GFun (fd, _) -> fd.svar.vname = fname
+        | _ -> false
+      in
+      if not (List.exists is_fun file.globals) then
+        Response.Error.(raise (make ~code:RequestFailed ~message:("Not a function: " ^ fname) ()))
+    ) demand;
   Messages.Table.(MH.clear messages_table);
   Messages.(Table.MH.clear final_table);
   Messages.Table.messages_list := [];
-  let file, reparsed = reparse s in
   if reset then (
     let max_ids = MaxIdUtil.get_file_max_ids file in
     s.max_ids <- max_ids;
     Serialize.Cache.reset_data SolverData;
     Serialize.Cache.reset_data AnalysisData);
+  GobConfig.set_list "incremental.demand.funs" (List.map (fun fname -> `String fname) demand);
   let increment_data, fresh = increment_data s file reparsed in
   ResettableLazy.reset node_locator;
   ResettableLazy.reset s.arg_wrapper;
@@ -300,7 +314,8 @@ let analyze ?(reset=false) (s: t) =
   s.file <- Some file;
   GobConfig.set_bool "incremental.load" (not fresh);
   Fun.protect ~finally:(fun () ->
-      GobConfig.set_bool "incremental.load" true
+      GobConfig.set_bool "incremental.load" true;
+      GobConfig.set_list "incremental.demand.funs" []
     ) (fun () ->
       Maingoblint.do_analyze increment_data (Option.get s.file);
       Maingoblint.do_gobview (Option.get s.file);
@@ -311,15 +326,18 @@ let () =
 
   register (module struct
     let name = "analyze"
-    type params = { reset: bool [@default false] } [@@deriving of_yojson]
+    type params = {
+      reset: bool [@default false];
+      demand: string list [@default []]; (** Only re-solve these functions, reusing previous results for the rest. *)
+    } [@@deriving of_yojson]
     (* TODO: Return analysis results as JSON. Useful for GobPie. *)
     type status = Success | VerifyError | Aborted [@@deriving to_yojson]
     type response = { status: status } [@@deriving to_yojson]
     (* TODO: Add options to control the analysis precision/context for specific functions. *)
     (* TODO: Add option to mark functions as modified. *)
-    let process { reset } serve =
+    let process { reset; demand } serve =
       try
-        analyze serve ~reset;
+        analyze serve ~reset ~demand;
         (* TODO: generalize VerifyError for AnalysisState.unsound_both_branches_dead *)
         {status = if !AnalysisState.verified = Some false then VerifyError else Success}
       with
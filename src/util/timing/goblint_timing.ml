@@ -93,20 +93,23 @@ struct
   let stop () =
     enabled := false
 
+  let find_child (tree: tree) name =
+    let rec loop = function
+      | child :: _ when child.name = name -> child
+      | _ :: children' -> loop children'
+      | [] ->
+        (* Not found, create new. *)
+        let tree' = create_tree name in
+        tree.children <- tree' :: tree.children;
+        tree'
+    in
+    loop tree.children
+
   let enter ?args name =
     (* Find the right tree. *)
     let tree: tree =
       let {tree; _} = Stack.top current in
-      let rec loop = function
-        | child :: _ when child.name = name -> child
-        | _ :: children' -> loop children'
-        | [] ->
-          (* Not found, create new. *)
-          let tree' = create_tree name in
-          tree.children <- tree' :: tree.children;
-          tree'
-      in
-      loop tree.children
+      find_child tree name
     in
     Stack.push (create_frame tree) current;
     if !options.tef then
@@ -162,6 +165,30 @@ struct
     else
       f x
 
+  let take_children () =
+    if !enabled then (
+      let {tree; _} = Stack.top current in
+      let children = tree.children in
+      tree.children <- [];
+      children
+    )
+    else
+      []
+
+  let rec add_tree parent (tree': tree) =
+    let tree = find_child parent tree'.name in
+    tree.cputime <- tree.cputime +. tree'.cputime;
+    tree.walltime <- tree.walltime +. tree'.walltime;
+    tree.allocated <- tree.allocated +. tree'.allocated;
+    tree.count <- tree.count + tree'.count;
+    List.iter (add_tree tree) (List.rev tree'.children) (* children are in reverse order of creation *)
+
+  let add_children trees =
+    if !enabled then (
+      let {tree; _} = Stack.top current in
+      List.iter (add_tree tree) (List.rev trees)
+    )
+
   (** Root tree with current (entered but not yet exited) frame resources added.
       This allows printing with in-progress resources also accounted for. *)
   let root_with_current () =
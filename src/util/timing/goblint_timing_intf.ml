@@ -52,6 +52,15 @@ sig
   (** [wrap name f x] runs [f x] and measures it as a timed section called [name].
       @param args custom data for TEF *)
 
+  (** {2 Forked processes} *)
+
+  val take_children: unit -> tree list
+  (** Remove and return the child nodes of the current timed section.
+      A forked process can use this to discard measurements inherited from its parent and to collect its own later. *)
+
+  val add_children: tree list -> unit
+  (** Add measurements of [trees], e.g. from a forked process, to the children of the current timed section. *)
+
   (** {2 Output} *)
 
   val print: Format.formatter -> unit
@@ -106,37 +106,143 @@ struct
 
   module NHT = BatHashtbl.Make (Node)
 
-  let create entrystates: (module BiArg with type Node.t = MyCFG.node * Spec.C.t * int) =
-    let (witness_prev_map, witness_prev, witness_next) =
-      (* Get all existing vars *)
-      let vars = NHT.create 100 in
-      LHT.iter (fun lvar local ->
-          ask_local lvar ~local (IterVars (fun i ->
+  (** Eagerly compute [prev] and [next] for the whole ARG. *)
+  let eager_edges () =
+    (* Get all existing vars *)
+    let vars = NHT.create 100 in
+    LHT.iter (fun lvar local ->
+        ask_local lvar ~local (IterVars (fun i ->
+            let lvar' = (fst lvar, snd lvar, i) in
+            NHT.replace vars lvar' ()
+          ))
+      ) lh;
+
+    let prev = NHT.create 100 in
+    let next = NHT.create 100 in
+    LHT.iter (fun lvar local ->
+        ignore (ask_local lvar ~local (Queries.IterPrevVars (fun i (prev_node, prev_c_obj, j) edge ->
+            let prev_lvar: NHT.key = (prev_node, Obj.obj prev_c_obj, j) in
+            (* Exclude accumulated prevs, which were pruned *)
+            if NHT.mem vars prev_lvar then (
               let lvar' = (fst lvar, snd lvar, i) in
-              NHT.replace vars lvar' ()
-            ))
-        ) lh;
-
-      let prev = NHT.create 100 in
-      let next = NHT.create 100 in
-      LHT.iter (fun lvar local ->
-          ignore (ask_local lvar ~local (Queries.IterPrevVars (fun i (prev_node, prev_c_obj, j) edge ->
-              let prev_lvar: NHT.key = (prev_node, Obj.obj prev_c_obj, j) in
-              (* Exclude accumulated prevs, which were pruned *)
-              if NHT.mem vars prev_lvar then (
-                let lvar' = (fst lvar, snd lvar, i) in
-                if M.tracing then M.trace "witness" "%s -( %a )-> %s" (Node.to_string prev_lvar) MyARG.pretty_inline_edge edge (Node.to_string lvar');
-                NHT.modify_def [] lvar' (fun prevs -> (edge, prev_lvar) :: prevs) prev;
-                NHT.modify_def [] prev_lvar (fun nexts -> (edge, lvar') :: nexts) next
-              )
-            )))
+              if M.tracing then M.trace "witness" "%s -( %a )-> %s" (Node.to_string prev_lvar) MyARG.pretty_inline_edge edge (Node.to_string lvar');
+              NHT.modify_def [] lvar' (fun prevs -> (edge, prev_lvar) :: prevs) prev;
+              NHT.modify_def [] prev_lvar (fun nexts -> (edge, lvar') :: nexts) next
+            )
+          )))
+      ) lh;
+
+    (NHT.length prev,
+     (fun n ->
+        NHT.find_default prev n []), (* main entry is not in prev at all *)
+     (fun n ->
+        NHT.find_default next n [])) (* main return is not in next at all *)
+
+  (** Maximum number of nodes per generation, whose [prev] or [next] are cached by {!lazy_edges}. *)
+  let lazy_cache_size = 10000
+
+  (** Compute [prev] and [next] on demand from [lh] and the CFG.
+
+      Predecessors are directly given by [IterPrevVars] of the node.
+      Intraprocedural successors are found by [IterPrevVars] of CFG successors in the same context.
+      Interprocedural successors (entries and returns of calls, thread entries) are only found by a reverse index,
+      which is built on first use from function entry and after-call nodes only. *)
+  let lazy_edges () =
+    (* Two generations approximate LRU eviction: when the young generation is full, it replaces the old one,
+       whose hits are promoted to the young one, so nodes around the current position of a traversal stay cached. *)
+    let cached f =
+      let young = ref (NHT.create 100) in
+      let old = ref (NHT.create 1) in
+      fun n ->
+        match NHT.find_option !young n with
+        | Some r -> r
+        | None ->
+          let r = match NHT.find_option !old n with
+            | Some r -> r
+            | None -> f n
+          in
+          if NHT.length !young >= lazy_cache_size then (
+            old := !young;
+            young := NHT.create 100
+          );
+          NHT.replace !young n r;
+          r
+    in
+    let prevs_of_lvar lvar =
+      let prevs = ref [] in
+      ignore (ask_local lvar (Queries.IterPrevVars (fun i (prev_node, prev_c_obj, j) edge ->
+          let prev_lvar: NHT.key = (prev_node, Obj.obj prev_c_obj, j) in
+          prevs := (i, edge, prev_lvar) :: !prevs
+        )));
+      !prevs
+    in
+    (* Exclude accumulated prevs, which were pruned *)
+    let is_var = cached (fun (n, c, i) ->
+        LHT.mem lh (n, c) && List.mem i (ask_indices (n, c))
+      )
+    in
+    let prev = cached (fun (n, c, i) ->
+        List.filter_map (fun (i', edge, prev_lvar) ->
+            if i' = i && is_var prev_lvar then
+              Some (edge, prev_lvar)
+            else
+              None
+          ) (prevs_of_lvar (n, c))
+      )
+    in
+    let is_after_call n =
+      List.exists (fun (edges, _) ->
+          List.exists (function (_, Proc _) -> true | _ -> false) edges
+        ) (FileCfg.Cfg.prev n)
+    in
+    let inter_next = lazy (
+      let inter_next = NHT.create 100 in
+      LHT.iter (fun ((n, c) as lvar) _ ->
+          let is_inter_target = match n with
+            | FunctionEntry _ -> true
+            | Statement _ -> is_after_call n
+            | Function _ -> false
+          in
+          if is_inter_target then (
+            List.iter (fun (i, edge, prev_lvar) ->
+                match edge with
+                | MyARG.InlineEntry _ | MyARG.InlineReturn _ | MyARG.ThreadEntry _ when is_var prev_lvar ->
+                  NHT.modify_def [] prev_lvar (List.cons (edge, (n, c, i))) inter_next
+                | _ -> ()
+              ) (prevs_of_lvar lvar)
+          )
         ) lh;
+      inter_next
+    )
+    in
+    let next = cached (fun ((n, c, _) as node) ->
+        let intra_next =
+          FileCfg.Cfg.next n
+          |> List.map snd
+          |> List.sort_uniq CfgNode.compare
+          |> List.concat_map (fun to_n ->
+              if LHT.mem lh (to_n, c) then
+                List.filter_map (fun (i, edge, prev_lvar) ->
+                    match edge with
+                    | MyARG.InlineEntry _ | MyARG.InlineReturn _ | MyARG.ThreadEntry _ -> None
+                    | MyARG.CFGEdge _ | MyARG.InlinedEdge _ when Node.equal prev_lvar node -> Some (edge, (to_n, c, i))
+                    | MyARG.CFGEdge _ | MyARG.InlinedEdge _ -> None
+                  ) (prevs_of_lvar (to_n, c))
+              else
+                []
+            )
+        in
+        intra_next @ NHT.find_default (Lazy.force inter_next) node []
+      )
+    in
+    (100, prev, next)
 
-      (prev,
-       (fun n ->
-          NHT.find_default prev n []), (* main entry is not in prev at all *)
-       (fun n ->
-          NHT.find_default next n [])) (* main return is not in next at all *)
+  let create entrystates: (module BiArg with type Node.t = MyCFG.node * Spec.C.t * int) =
+    let (witness_size, witness_prev, witness_next) =
+      if GobConfig.get_bool "exp.arg.lazy" then
+        lazy_edges ()
+      else
+        eager_edges ()
     in
     let witness_main =
       let lvar = WitnessUtil.find_main_entry entrystates in
@@ -165,7 +271,7 @@ struct
 
       (** Iterate over {e reachable} nodes. *)
       let iter_nodes (f: Node.t -> unit): unit =
-        let reachable = NHT.create (NHT.length witness_prev_map) in
+        let reachable = NHT.create witness_size in
 
         (* DFS *)
         let rec iter_node node =
@@ -0,0 +1,25 @@
+#include <goblint.h>
+
+struct s {
+  int a;
+  int b;
+};
+
+struct s g = {1, 2};
+
+int get() {
+  return g.b; // fingerprint changes with struct s
+}
+
+int unchanged(int z) {
+  int w = z + 1;
+  return w;
+}
+
+int main() {
+  int x = get();
+  __goblint_check(x == 2); // success before, success after
+  int y = unchanged(2);
+  __goblint_check(y == 3); // success before, success after
+  return 0;
+}
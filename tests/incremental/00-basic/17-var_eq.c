@@ -0,0 +1,27 @@
+// Interned expressions of the loaded var_eq states must not collide with those interned after loading.
+#include <stdio.h>
+#include <goblint.h>
+
+int g1, g2;
+
+void f() {
+  int a;
+  int b;
+  scanf("%d", &a);
+  b = a;
+  __goblint_check(a == b);
+  g1 = a;
+  g2 = b;
+}
+
+int main() {
+  int x;
+  int y;
+  scanf("%d", &x);
+  scanf("%d", &y);
+  f();
+  __goblint_check(x == y); // UNKNOWN!
+  y = x;
+  __goblint_check(x == y);
+  return 0;
+}
@@ -0,0 +1,15 @@
+// Only the initializer of a global changes, so all start variables stay stable.
+// Its batched side effect must still destabilize the readers of the global.
+#include <goblint.h>
+
+int g = 1;
+
+int read() {
+  return g;
+}
+
+int main() {
+  int x = read();
+  __goblint_check(x == 1);
+  return 0;
+}
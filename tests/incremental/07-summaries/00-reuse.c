@@ -0,0 +1,15 @@
+#include <goblint.h>
+// CRAM
+int g;
+
+int lib(int x) {
+  __goblint_check(x == 1);
+  g = x;
+  return x + 1;
+}
+
+int main() {
+  int r = lib(1);
+  __goblint_check(r == 2);
+  return 0;
+}
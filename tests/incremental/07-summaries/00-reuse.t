@@ -0,0 +1,19 @@
+Run Goblint on initial program version and export summaries
+
+  $ goblint --conf 00-reuse.json --set incremental.summaries.save summaries.data 00-reuse.c 2>&1 | grep 'Assert'
+  [Success][Assert] Assertion "x == 1" will succeed (00-reuse.c:6:3-6:26)
+  [Success][Assert] Assertion "r == 2" will succeed (00-reuse.c:13:3-13:26)
+
+Apply patch, which shifts variable ids and lines
+
+  $ chmod +w 00-reuse.c
+  $ patch -b <00-reuse.patch
+  patching file 00-reuse.c
+
+Run Goblint on new program version with imported summaries and check that they are reused with their messages
+
+  $ goblint --conf 00-reuse.json --set incremental.summaries.load summaries.data 00-reuse.c 2>&1 | grep -E 'Assert|summaries|Summaries' | sed -E 's/[1-9][0-9]* of [0-9]+ functions/N of M functions/; s/[1-9][0-9]* uses/N uses/'
+  [Info] Imported summaries of N of M functions from summaries.data
+  [Info] Summaries: N uses, 0 fallbacks to solving
+  [Success][Assert] Assertion "x == 1" will succeed (00-reuse.c:10:3-10:26)
+  [Success][Assert] Assertion "r == 2" will succeed (00-reuse.c:17:3-17:26)
@@ -0,0 +1,18 @@
+#include <goblint.h>
+// CRAM
+int f(int x) {
+  int y = x * 2;
+  __goblint_check(y == 2);
+  return y;
+}
+
+int g(int x) {
+  return x + 1;
+}
+
+int main() {
+  int a = f(1);
+  int b = g(a);
+  __goblint_check(b == 3);
+  return 0;
+}
@@ -0,0 +1,24 @@
+Run Goblint on initial program version
+
+  $ goblint --conf 00-demand.json --enable incremental.save 00-demand.c 2>&1 | grep 'Assert'
+  [Success][Assert] Assertion "y == 2" will succeed (00-demand.c:5:3-5:26)
+  [Success][Assert] Assertion "b == 3" will succeed (00-demand.c:16:3-16:26)
+
+Apply patch, which changes the return value of f
+
+  $ chmod +w 00-demand.c
+  $ patch -b <00-demand.patch
+  patching file 00-demand.c
+
+Re-solve only f on demand: f is evaluated again, while main keeps its stored results (and thus its outdated check) for this run
+
+  $ goblint --conf 00-demand.json --enable incremental.load --set incremental.demand.funs[+] f 00-demand.c 2>&1 | grep -E 'Assert|Demand-driven'
+  [Info] Demand-driven solving evaluated unknowns of functions: f
+  [Success][Assert] Assertion "y == 3" will succeed (00-demand.c:5:3-5:26)
+  [Success][Assert] Assertion "b == 3" will succeed (00-demand.c:16:3-16:26)
+
+Without demand, the change is propagated to main
+
+  $ goblint --conf 00-demand.json --enable incremental.load 00-demand.c 2>&1 | grep -E 'Assert|Demand-driven'
+  [Success][Assert] Assertion "y == 3" will succeed (00-demand.c:5:3-5:26)
+  [Error][Assert] Assertion "b == 3" will fail. (00-demand.c:16:3-16:26)
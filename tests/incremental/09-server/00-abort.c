@@ -0,0 +1,14 @@
+#include <goblint.h>
+// CRAM
+int f(int x) {
+  int y = x * 2;
+  __goblint_check(y == 2);
+  return y;
+}
+
+int main() {
+  int a = f(1);
+  int b = a + 1;
+  __goblint_check(b == 3);
+  return 0;
+}
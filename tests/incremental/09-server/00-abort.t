@@ -0,0 +1,29 @@
+Analyze, abort a demand-driven re-analysis of f after some evaluations, then analyze again with the previous results
+
+  $ cat > requests.json <<EOF
+  > {"jsonrpc":"2.0","id":1,"method":"analyze","params":{}}
+  > {"jsonrpc":"2.0","id":2,"method":"messages"}
+  > {"jsonrpc":"2.0","id":3,"method":"config","params":["dbg.abort-evals",3]}
+  > {"jsonrpc":"2.0","id":4,"method":"analyze","params":{"demand":["f"]}}
+  > {"jsonrpc":"2.0","id":5,"method":"config","params":["dbg.abort-evals",0]}
+  > {"jsonrpc":"2.0","id":6,"method":"analyze","params":{}}
+  > {"jsonrpc":"2.0","id":7,"method":"messages"}
+  > EOF
+
+Warnings are also printed to stdout, so only keep the responses
+
+  $ goblint --enable server.enabled --set server.mode stdio 00-abort.c < requests.json 2>/dev/null | grep '^{' > responses.json
+
+  $ grep -o '"status":\[[^]]*\]' responses.json
+  "status":["Success"]
+  "status":["Aborted"]
+  "status":["Success"]
+
+The aborted analysis didn't modify the previous results, so the last analysis reuses them and reports the same
+
+  $ sed -n 2p responses.json | grep -o 'Assertion[^,]*will [a-z]*' | sort > before
+  $ sed -n 7p responses.json | grep -o 'Assertion[^,]*will [a-z]*' | sort > after
+  $ cat before
+  Assertion \"b == 3\" will succeed
+  Assertion \"y == 2\" will succeed
+  $ diff before after
@@ -0,0 +1,34 @@
+// PARAM: --enable solvers.td3.callgraph-order
+#include <goblint.h>
+
+int g;
+
+int leaf(int x) {
+  return x + 1;
+}
+
+int even(int n);
+
+int odd(int n) {
+  if (n <= 0)
+    return 0;
+  return even(n - 1);
+}
+
+int even(int n) {
+  if (n <= 0)
+    return 1;
+  return odd(n - 1);
+}
+
+int mid(int x) {
+  g = leaf(x);
+  return odd(x);
+}
+
+int main() {
+  int r = mid(3);
+  __goblint_check(g == 4);
+  __goblint_check(r == 1);
+  return leaf(r);
+}
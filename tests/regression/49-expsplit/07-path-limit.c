@@ -0,0 +1,33 @@
+// PARAM: --set ana.activated[+] expsplit --set ana.path_sens_limit 2
+#include <goblint.h>
+
+int main() {
+  int r; // rand
+  int x, v;
+
+  __goblint_split_begin(x);
+  if (r == 0) {
+    x = 1;
+    v = 10;
+  }
+  else if (r == 1) {
+    x = 2;
+    v = 20;
+  }
+  else {
+    x = 3;
+    v = 30;
+  }
+
+  // only the excess paths are merged, the first is kept
+  if (x == 1) {
+    __goblint_check(v == 10);
+  }
+  if (x == 2) {
+    __goblint_check(v == 20); // UNKNOWN (intentionally)
+  }
+
+  __goblint_split_end(x);
+
+  return 0;
+}
@@ -0,0 +1,6 @@
+Exceeding ana.path_sens_limit merges only the excess paths.
+
+  $ goblint --enable warn.deterministic --set ana.activated[+] expsplit --set ana.path_sens_limit 2 07-path-limit.c 2>&1 | grep -E 'Assert|PathSensitive2' | sed -E 's/[1-9][0-9]* merges removing [1-9][0-9]* paths/N merges removing M paths/'
+  [Info] PathSensitive2: at most 3 paths, N merges removing M paths due to ana.path_sens_limit
+  [Success][Assert] Assertion "v == 10" will succeed (07-path-limit.c:24:5-24:28)
+  [Warning][Assert] Assertion "v == 20" is unknown. (07-path-limit.c:27:5-27:28)
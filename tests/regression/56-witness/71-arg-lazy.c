@@ -0,0 +1,27 @@
+// PARAM: --enable exp.arg.enabled --enable exp.arg.lazy
+#include <pthread.h>
+#include <goblint.h>
+
+int g;
+
+int add(int x, int y) {
+  return x + y;
+}
+
+void *t_fun(void *arg) {
+  g = add(1, 2);
+  return NULL;
+}
+
+int main() {
+  pthread_t id;
+  pthread_create(&id, NULL, t_fun, NULL);
+  int s = 0;
+  for (int i = 0; i < 3; i++) {
+    if (i % 2)
+      s = add(s, i);
+  }
+  int r = add(1, 1);
+  __goblint_check(r == 2);
+  return 0;
+}
@@ -0,0 +1,11 @@
+Construct the ARG eagerly and lazily
+
+  $ goblint --enable exp.arg.enabled --set exp.arg.dot.path eager.dot 71-arg-lazy.c > /dev/null 2>&1
+  $ goblint --enable exp.arg.enabled --enable exp.arg.lazy --set exp.arg.dot.path lazy.dot 71-arg-lazy.c > /dev/null 2>&1
+
+Both have the same nodes and edges, only the order of successors may differ
+
+  $ grep -q 'Entry main' eager.dot
+  $ sort eager.dot > eager-sorted.dot
+  $ sort lazy.dot > lazy-sorted.dot
+  $ diff eager-sorted.dot lazy-sorted.dot
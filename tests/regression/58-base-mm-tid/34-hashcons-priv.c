@@ -0,0 +1,36 @@
+// PARAM: --set ana.path_sens[+] threadflag --set ana.base.privatization mutex-meet-tid --enable ana.int.interval --set ana.activated[+] threadJoins --enable ana.opt.hashcons-priv
+#include <pthread.h>
+#include <goblint.h>
+
+int g = 10;
+int h = 10;
+pthread_mutex_t A = PTHREAD_MUTEX_INITIALIZER;
+
+void *t_fun(void *arg) {
+  pthread_mutex_lock(&A);
+  g = 11;
+  h = 11;
+  pthread_mutex_unlock(&A);
+  return NULL;
+}
+
+int main(void) {
+  pthread_t id[4];
+  for (int i = 0; i < 4; i++)
+    pthread_create(&id[i], NULL, t_fun, NULL);
+
+  pthread_mutex_lock(&A);
+  __goblint_check(g >= 10);
+  __goblint_check(g == 10); //UNKNOWN!
+  pthread_mutex_unlock(&A);
+
+  pthread_mutex_lock(&A);
+  g = 12;
+  h = 12;
+  pthread_mutex_unlock(&A);
+
+  pthread_mutex_lock(&A);
+  __goblint_check(g <= 12);
+  pthread_mutex_unlock(&A);
+  return 0;
+}
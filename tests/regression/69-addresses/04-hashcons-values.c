@@ -0,0 +1,36 @@
+// PARAM: --enable ana.opt.hashcons-values
+#include <pthread.h>
+#include <goblint.h>
+
+int g, h;
+int *p = &g;
+pthread_mutex_t m = PTHREAD_MUTEX_INITIALIZER;
+
+void *t_fun(void *arg) {
+  pthread_mutex_lock(&m);
+  p = &h;
+  pthread_mutex_unlock(&m);
+  return NULL;
+}
+
+int main() {
+  int *q;
+  int r;
+  if (r)
+    q = &g;
+  else
+    q = &h;
+  __goblint_check(q == &g); // UNKNOWN!
+  __goblint_check(q != 0);
+
+  int *s = q;
+  __goblint_check(s == q);
+
+  pthread_t id;
+  pthread_create(&id, NULL, t_fun, NULL);
+  pthread_mutex_lock(&m);
+  __goblint_check(p == &g); // UNKNOWN!
+  __goblint_check(p == &g || p == &h);
+  pthread_mutex_unlock(&m);
+  return 0;
+}
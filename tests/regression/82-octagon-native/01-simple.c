@@ -0,0 +1,16 @@
+// SKIP PARAM: --enable ana.int.interval --set ana.activated[+] octagon --set sem.int.signed_overflow assume_none
+// Example from https://www-apr.lip6.fr/~mine/publi/article-mine-HOSC06.pdf
+#include <goblint.h>
+
+void main(void) {
+  int X = 0;
+  int N = rand();
+  if(N < 0) { N = 0; }
+
+  while(X < N) {
+    X++;
+  }
+
+  __goblint_check(X-N == 0);
+  __goblint_check(X == N);
+}
@@ -0,0 +1,26 @@
+// SKIP PARAM: --set ana.activated[+] octagon --set sem.int.signed_overflow assume_none
+#include <goblint.h>
+
+int main(void) {
+  int x = rand();
+  int y = rand();
+  int z;
+
+  if (x + y <= 10 && x - y <= 2 && y >= 0) {
+    __goblint_check(x <= 6);
+    __goblint_check(x + y <= 10);
+    z = x + 1;
+    __goblint_check(z - x == 1);
+    __goblint_check(z + y <= 11);
+    z = -x;
+    __goblint_check(z + x == 0);
+    __goblint_check(y - z <= 10);
+  }
+
+  if (x < y) {
+    __goblint_check(x - y <= -1);
+    __goblint_check(y > x);
+    __goblint_check(x == y); // FAIL
+  }
+  return 0;
+}
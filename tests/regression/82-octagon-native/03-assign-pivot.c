@@ -0,0 +1,21 @@
+// SKIP PARAM: --set ana.activated[+] octagon --set sem.int.signed_overflow assume_none
+#include <goblint.h>
+
+int main(void) {
+  int x;
+  int y = rand();
+  int z = rand();
+
+  if (y - z <= 0) {
+    x = y;
+    __goblint_check(x - z <= 0);
+    __goblint_check(x - y == 0);
+  }
+
+  if (y <= 5) {
+    if (z - y <= 1) {
+      __goblint_check(z <= 6);
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,17 @@
+// PARAM: --enable warn.stream --enable warn.deterministic --enable ana.int.interval
+#include <goblint.h>
+
+int main() {
+  int x = rand();
+  int y = 0;
+
+  for (int i = 0; i < 10; i++) {
+    __goblint_check(i < 10);
+    __goblint_check(i == 0); // UNKNOWN!
+    y = x + i;
+  }
+
+  __goblint_check(x == 0); // UNKNOWN!
+  __goblint_check(y == 0); // UNKNOWN!
+  return 0;
+}
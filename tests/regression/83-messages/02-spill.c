@@ -0,0 +1,18 @@
+// PARAM: --enable warn.stream --set warn.stream-run-length 2 --enable warn.deterministic --enable ana.int.interval
+#include <goblint.h>
+
+int main() {
+  int x = rand();
+  int a = 1;
+  int b = 2;
+
+  __goblint_check(b == 2);
+  __goblint_check(x == 0); // UNKNOWN!
+  __goblint_check(a == 1);
+  __goblint_check(a < b);
+  __goblint_check(x == 1); // UNKNOWN!
+  __goblint_check(a + b == 3);
+  __goblint_check(x == 2); // UNKNOWN!
+  __goblint_check(b - a == 1);
+  return 0;
+}
@@ -0,0 +1,7 @@
+Messages are spilled in runs of two, which are merged into the same order as without streaming
+
+  $ goblint --enable warn.deterministic --enable ana.int.interval 02-spill.c > memory.txt
+  $ goblint --enable warn.stream --set warn.stream-run-length 2 --enable warn.deterministic --enable ana.int.interval 02-spill.c > stream.txt
+  $ diff memory.txt stream.txt
+  $ grep -c Assert stream.txt
+  8
@@ -0,0 +1,12 @@
+// PARAM: --enable ana.int.interval --set solvers.td3.budget.evals 5
+#include <goblint.h>
+
+int main() { // WARN (solving budget)
+  int i = 0;
+  while (i < 100) {
+    i++;
+  }
+  __goblint_check(i >= 100);
+  __goblint_check(i == 100); // UNKNOWN! (not narrowed)
+  return 0;
+}
@@ -0,0 +1,30 @@
+// PARAM: --enable ana.int.interval --enable exp.bulk_global_inits
+#include <goblint.h>
+
+struct point {
+  int x;
+  int y;
+};
+
+int table[5] = {1, 2, 3};
+struct point origin = {.y = 7};
+struct point points[2] = {{1, 2}, {3, 4}};
+int zeros[100];
+int g = 42;
+int *ptrs[3]; // not bulk: pointers
+char buf[10]; // not bulk: characters
+
+int main() {
+  __goblint_check(table[0] >= 0);
+  __goblint_check(table[1] <= 3);
+  __goblint_check(table[4] == 0); // UNKNOWN (joined with other elements)
+  __goblint_check(origin.x == 0);
+  __goblint_check(origin.y == 7);
+  __goblint_check(points[1].x >= 1);
+  __goblint_check(points[0].y <= 4);
+  __goblint_check(zeros[50] == 0);
+  __goblint_check(g == 42);
+  __goblint_check(ptrs[1] == 0);
+  __goblint_check(buf[2] == 0);
+  return 0;
+}
@@ -0,0 +1,20 @@
+// PARAM: --enable ana.int.interval --enable exp.bulk_global_inits --disable exp.fast_global_inits --set ana.base.arrays.domain unroll --set ana.base.arrays.unrolling-factor 3
+#include <goblint.h>
+
+// not bulk: unrolled arrays keep their per-element initializers
+int t[3] = {1, 2, 3};
+
+struct s {
+  int a[2];
+  int b;
+} g = {{4, 5}, 6};
+
+int main() {
+  __goblint_check(t[0] == 1);
+  __goblint_check(t[1] == 2);
+  __goblint_check(t[2] == 3);
+  __goblint_check(g.a[0] == 4);
+  __goblint_check(g.a[1] == 5);
+  __goblint_check(g.b == 6);
+  return 0;
+}
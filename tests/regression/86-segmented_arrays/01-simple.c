@@ -0,0 +1,29 @@
+// PARAM: --enable ana.int.interval --set ana.base.arrays.domain segmented
+#include <goblint.h>
+
+int main(void) {
+  int r;
+  int a[1000];
+  a[4] = 4;
+  a[6] = 6;
+  a[500] = 10;
+  __goblint_check(a[4] == 4);
+  __goblint_check(a[6] == 6);
+  __goblint_check(a[500] == 10);
+  __goblint_check(a[5] == 0); // UNKNOWN
+
+  int i = r ? 10 : 20;
+  a[i] = 3;
+  __goblint_check(a[4] == 4);
+  __goblint_check(a[500] == 10);
+  __goblint_check(a[15] == 3); // UNKNOWN
+
+  if (r)
+    a[7] = 1;
+  else
+    a[7] = 2;
+  __goblint_check(a[7] >= 1);
+  __goblint_check(a[7] <= 2);
+  __goblint_check(a[6] == 6);
+  return 0;
+}
@@ -0,0 +1,16 @@
+// PARAM: --enable ana.int.interval --set ana.base.arrays.domain segmented --set ana.base.arrays.segments 3
+#include <goblint.h>
+
+int main(void) {
+  int a[100];
+  a[0] = 0;
+  a[1] = 1;
+  __goblint_check(a[0] == 0);
+  __goblint_check(a[1] == 1);
+
+  a[5] = 5; // segments from index 2 are joined
+  __goblint_check(a[0] == 0);
+  __goblint_check(a[1] == 1);
+  __goblint_check(a[5] == 5); // UNKNOWN
+  return 0;
+}
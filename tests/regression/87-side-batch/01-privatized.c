@@ -0,0 +1,37 @@
+// PARAM: --enable ana.int.interval --enable solvers.td3.side-batch
+#include <pthread.h>
+#include <goblint.h>
+
+int g = 0;
+int h = 0;
+pthread_mutex_t m = PTHREAD_MUTEX_INITIALIZER;
+
+void *t1(void *arg) {
+  pthread_mutex_lock(&m);
+  g = 1;
+  h = g;
+  pthread_mutex_unlock(&m);
+  return NULL;
+}
+
+void *t2(void *arg) {
+  pthread_mutex_lock(&m);
+  g = 2;
+  __goblint_check(h >= 0);
+  __goblint_check(h <= 2);
+  pthread_mutex_unlock(&m);
+  return NULL;
+}
+
+int main(void) {
+  pthread_t id1, id2;
+  pthread_create(&id1, NULL, t1, NULL);
+  pthread_create(&id2, NULL, t2, NULL);
+  pthread_mutex_lock(&m);
+  __goblint_check(g >= 0);
+  __goblint_check(g <= 2);
+  __goblint_check(g == 0); // UNKNOWN!
+  __goblint_check(h == 1); // UNKNOWN!
+  pthread_mutex_unlock(&m);
+  return 0;
+}
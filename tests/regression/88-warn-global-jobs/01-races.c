@@ -0,0 +1,38 @@
+// PARAM: --set jobs 2
+#include <pthread.h>
+#include <stdio.h>
+
+int g1, g2, g3, g4, g5, g6;
+pthread_mutex_t m1 = PTHREAD_MUTEX_INITIALIZER;
+pthread_mutex_t m2 = PTHREAD_MUTEX_INITIALIZER;
+
+void *t_fun(void *arg) {
+  pthread_mutex_lock(&m1);
+  g1++; // RACE!
+  g2++; // NORACE
+  pthread_mutex_unlock(&m1);
+  g3++; // RACE!
+  g5++; // RACE!
+  pthread_mutex_lock(&m2);
+  g4++; // NORACE
+  g6++; // NORACE
+  pthread_mutex_unlock(&m2);
+  return NULL;
+}
+
+int main(void) {
+  pthread_t id;
+  pthread_create(&id, NULL, t_fun, NULL);
+  pthread_mutex_lock(&m2);
+  g1++; // RACE!
+  g4++; // NORACE
+  g6++; // NORACE
+  pthread_mutex_unlock(&m2);
+  pthread_mutex_lock(&m1);
+  g2++; // NORACE
+  g3++; // RACE!
+  pthread_mutex_unlock(&m1);
+  g5++; // RACE!
+  pthread_join(id, NULL);
+  return 0;
+}
@@ -0,0 +1,29 @@
+// PARAM: --enable dbg.heap-breakdown.enabled --set ana.dead-code.branches true
+#include <pthread.h>
+#include <goblint.h>
+
+int g;
+pthread_mutex_t m = PTHREAD_MUTEX_INITIALIZER;
+
+int f(int x) {
+  return x + 1;
+}
+
+void *t_fun(void *arg) {
+  pthread_mutex_lock(&m);
+  g = f(g);
+  pthread_mutex_unlock(&m);
+  return NULL;
+}
+
+int main(void) {
+  pthread_t id;
+  int x = f(1);
+  __goblint_check(x == 2);
+  pthread_create(&id, NULL, t_fun, NULL);
+  pthread_mutex_lock(&m);
+  g = f(x);
+  pthread_mutex_unlock(&m);
+  pthread_join(id, NULL);
+  return 0;
+}
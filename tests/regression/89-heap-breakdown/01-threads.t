@@ -0,0 +1,28 @@
+Report reachable words by component, function and context after solving.
+
+  $ goblint --enable dbg.heap-breakdown.enabled 01-threads.c > output.txt 2>&1
+
+  $ grep 'Heap breakdown' output.txt | sed -E 's/[0-9]+(\.[0-9]+)?/N/g'
+  [Info] Heap breakdown by component: N words (N MiB) reachable over baseline of N words (N MiB)
+  [Info] Heap breakdown by function: top N of N measured of N
+  [Info] Heap breakdown by function and context: top N of N measured of N
+
+Analysis components, solver tables and functions are reported as groups.
+
+  $ grep -oE '  (base\.D|base\.C|mutex\.G|solver\.(lh|gh|data))$' output.txt | sort
+    base.C
+    base.D
+    mutex.G
+    solver.data
+    solver.gh
+    solver.lh
+
+  $ grep -oE 'MiB\)  (main|t_fun|f)$' output.txt | sort
+  MiB)  f
+  MiB)  main
+  MiB)  t_fun
+
+Only the functions with most unknowns are measured, if limited.
+
+  $ goblint --enable dbg.heap-breakdown.enabled --set dbg.heap-breakdown.measure 1 01-threads.c 2>&1 | grep 'Heap breakdown by function:'
+  [Info] Heap breakdown by function: top 1 of 1 measured of 3
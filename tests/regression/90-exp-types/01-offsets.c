@@ -0,0 +1,41 @@
+// PARAM: --enable ana.opt.exp-types --enable ana.int.interval
+#include <goblint.h>
+
+struct inner {
+  int a[4];
+  int b;
+};
+
+struct outer {
+  int x;
+  int y;
+  struct inner in[2];
+  char c;
+};
+
+struct outer g;
+
+int main() {
+  int i = 1;
+  struct outer *p = &g;
+
+  g.x = 1;
+  g.y = 2;
+  g.in[0].a[2] = 3;
+  g.in[i].b = 4;
+  p->c = 'c';
+
+  __goblint_check(g.x == 1);
+  __goblint_check(g.y == 2);
+  __goblint_check(p->x == 1);
+  __goblint_check(g.in[0].a[2] == 3); // UNKNOWN
+  __goblint_check(g.in[1].b == 4); // UNKNOWN
+  __goblint_check(sizeof(g.in[1].a[3]) == sizeof(int));
+  __goblint_check(p->c == 'c');
+
+  int *q = &g.in[1].a[0];
+  *q = 5;
+  __goblint_check(g.in[1].a[0] == 5); // UNKNOWN
+  __goblint_check(*q >= 0);
+  return 0;
+}